@@ -0,0 +1,25 @@
+#include "accel.h"
+
+//was mouseMoveMult = 1, mouseMovePwr = 1.2
+#ifndef MOUSE_ACCEL_CURVE
+#define MOUSE_ACCEL_CURVE accelCurve_m1_p1_2
+#endif
+
+const int *mouseAccelCurve = MOUSE_ACCEL_CURVE;
+
+
+static int curveIndex(const int *curve){
+    for(int i = 0; i < ACCEL_CURVE_COUNT; i++){
+        if(accelCurves[i] == curve){
+            return i;
+        }
+    }
+    return 0;
+}
+
+int mouseAccelCurveIndex = curveIndex(MOUSE_ACCEL_CURVE);
+
+
+void accelCurveChanged(void){
+    mouseAccelCurve = accelCurves[mouseAccelCurveIndex];
+}
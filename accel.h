@@ -0,0 +1,57 @@
+#ifndef ACCEL_H
+#define ACCEL_H
+
+//******************************************************************
+// Pointer acceleration curve
+//******************************************************************
+//
+// mouseMoveMult * |d|^mouseMovePwr used to be evaluated with powf for
+// both axes on every report (soft float, no FPU on the M3). the curve
+// is now precomputed into the integer tables in accel_table.h and
+// looked up by the delta.
+//
+// deltas and results are fixed point with ACCEL_FRAC_BITS fractional
+// bits, so slow motion is not rounded to zero on the way through.
+//
+// pick a curve at compile time with -DMOUSE_ACCEL_CURVE=<table name>,
+// see accel_table.h for the available ones. the pc shell switches
+// curves at runtime by their index in accelCurves[].
+
+#include "accel_table.h"
+
+//table in use, indexed by whole |d|
+extern const int *mouseAccelCurve;
+
+//index of the table in use in accelCurves[]
+extern int mouseAccelCurveIndex;
+
+//makes mouseAccelCurveIndex the table in use
+void accelCurveChanged(void);
+
+//most accelerated motion per delta, a report tick can't carry more
+#define ACCEL_OUT_MAX (32767 << ACCEL_FRAC_BITS)
+
+//accelerated delta, both in ACCEL_FRAC_BITS fixed point
+//linear between the table entries. past the end of the table the last
+//segment is carried on, so a flick keeps growing instead of stopping
+//at the last entry, up to ACCEL_OUT_MAX
+inline int accelCurve(int d){
+    int mag = (d < 0) ? -d : d;
+    int i = mag >> ACCEL_FRAC_BITS;
+    int out;
+    if(i >= ACCEL_TABLE_SIZE - 1){
+        int last = mouseAccelCurve[ACCEL_TABLE_SIZE - 1];
+        long long slope = last - mouseAccelCurve[ACCEL_TABLE_SIZE - 2];
+        long long past = mag - ((ACCEL_TABLE_SIZE - 1) << ACCEL_FRAC_BITS);
+        long long extended = last + ((slope * past) >> ACCEL_FRAC_BITS);
+        out = (extended > ACCEL_OUT_MAX) ? ACCEL_OUT_MAX : (int)extended;
+    } else {
+        int frac = mag & ((1 << ACCEL_FRAC_BITS) - 1);
+        int lo = mouseAccelCurve[i];
+        int hi = mouseAccelCurve[i + 1];
+        out = lo + (((hi - lo) * frac) >> ACCEL_FRAC_BITS);
+    }
+    return (d < 0) ? -out : out;
+}
+
+#endif
@@ -0,0 +1,120 @@
+// Generated by host/gen_accel_table.cpp, do not edit
+// regenerate with: make -f Makefile.host accel_table
+
+#ifndef ACCEL_TABLE_H
+#define ACCEL_TABLE_H
+
+#define ACCEL_TABLE_SIZE 256
+#define ACCEL_FRAC_BITS 8
+
+//mouseMoveMult = 1, mouseMovePwr = 1
+static const int accelCurve_m1_p1_0[ACCEL_TABLE_SIZE] = {
+    0, 256, 512, 768, 1024, 1280, 1536, 1792, 2048, 2304, 2560, 2816, 3072, 3328, 3584, 3840,
+    4096, 4352, 4608, 4864, 5120, 5376, 5632, 5888, 6144, 6400, 6656, 6912, 7168, 7424, 7680, 7936,
+    8192, 8448, 8704, 8960, 9216, 9472, 9728, 9984, 10240, 10496, 10752, 11008, 11264, 11520, 11776, 12032,
+    12288, 12544, 12800, 13056, 13312, 13568, 13824, 14080, 14336, 14592, 14848, 15104, 15360, 15616, 15872, 16128,
+    16384, 16640, 16896, 17152, 17408, 17664, 17920, 18176, 18432, 18688, 18944, 19200, 19456, 19712, 19968, 20224,
+    20480, 20736, 20992, 21248, 21504, 21760, 22016, 22272, 22528, 22784, 23040, 23296, 23552, 23808, 24064, 24320,
+    24576, 24832, 25088, 25344, 25600, 25856, 26112, 26368, 26624, 26880, 27136, 27392, 27648, 27904, 28160, 28416,
+    28672, 28928, 29184, 29440, 29696, 29952, 30208, 30464, 30720, 30976, 31232, 31488, 31744, 32000, 32256, 32512,
+    32768, 33024, 33280, 33536, 33792, 34048, 34304, 34560, 34816, 35072, 35328, 35584, 35840, 36096, 36352, 36608,
+    36864, 37120, 37376, 37632, 37888, 38144, 38400, 38656, 38912, 39168, 39424, 39680, 39936, 40192, 40448, 40704,
+    40960, 41216, 41472, 41728, 41984, 42240, 42496, 42752, 43008, 43264, 43520, 43776, 44032, 44288, 44544, 44800,
+    45056, 45312, 45568, 45824, 46080, 46336, 46592, 46848, 47104, 47360, 47616, 47872, 48128, 48384, 48640, 48896,
+    49152, 49408, 49664, 49920, 50176, 50432, 50688, 50944, 51200, 51456, 51712, 51968, 52224, 52480, 52736, 52992,
+    53248, 53504, 53760, 54016, 54272, 54528, 54784, 55040, 55296, 55552, 55808, 56064, 56320, 56576, 56832, 57088,
+    57344, 57600, 57856, 58112, 58368, 58624, 58880, 59136, 59392, 59648, 59904, 60160, 60416, 60672, 60928, 61184,
+    61440, 61696, 61952, 62208, 62464, 62720, 62976, 63232, 63488, 63744, 64000, 64256, 64512, 64768, 65024, 65280
+};
+
+//mouseMoveMult = 1, mouseMovePwr = 1.2
+static const int accelCurve_m1_p1_2[ACCEL_TABLE_SIZE] = {
+    0, 256, 588, 957, 1351, 1766, 2198, 2645, 3104, 3575, 4057, 4549, 5050, 5559, 6076, 6600,
+    7132, 7670, 8214, 8765, 9321, 9883, 10451, 11023, 11601, 12183, 12771, 13362, 13958, 14559, 15163, 15772,
+    16384, 17000, 17620, 18244, 18871, 19502, 20136, 20774, 21415, 22059, 22706, 23356, 24010, 24666, 25325, 25987,
+    26652, 27320, 27990, 28663, 29339, 30017, 30698, 31382, 32068, 32756, 33447, 34140, 34835, 35533, 36233, 36936,
+    37641, 38347, 39056, 39768, 40481, 41196, 41914, 42633, 43355, 44079, 44804, 45532, 46261, 46993, 47726, 48461,
+    49198, 49937, 50678, 51420, 52165, 52911, 53658, 54408, 55159, 55912, 56667, 57424, 58182, 58941, 59703, 60466,
+    61230, 61996, 62764, 63533, 64304, 65077, 65851, 66626, 67403, 68182, 68962, 69743, 70526, 71310, 72096, 72883,
+    73672, 74462, 75253, 76046, 76840, 77636, 78433, 79231, 80031, 80832, 81634, 82438, 83243, 84049, 84856, 85665,
+    86475, 87287, 88099, 88913, 89728, 90544, 91362, 92181, 93001, 93822, 94644, 95468, 96293, 97119, 97946, 98774,
+    99604, 100434, 101266, 102099, 102933, 103768, 104604, 105442, 106280, 107120, 107961, 108802, 109645, 110489, 111334, 112180,
+    113027, 113876, 114725, 115575, 116427, 117279, 118133, 118987, 119843, 120699, 121557, 122415, 123275, 124135, 124997, 125859,
+    126723, 127587, 128453, 129319, 130187, 131055, 131925, 132795, 133666, 134538, 135412, 136286, 137161, 138037, 138913, 139791,
+    140670, 141550, 142430, 143312, 144194, 145077, 145962, 146847, 147732, 148619, 149507, 150396, 151285, 152175, 153067, 153959,
+    154852, 155746, 156640, 157536, 158432, 159329, 160227, 161126, 162026, 162927, 163828, 164730, 165633, 166537, 167442, 168347,
+    169254, 170161, 171069, 171977, 172887, 173797, 174708, 175620, 176533, 177446, 178361, 179276, 180192, 181108, 182026, 182944,
+    183863, 184782, 185703, 186624, 187546, 188469, 189392, 190316, 191241, 192167, 193094, 194021, 194949, 195878, 196807, 197737
+};
+
+//mouseMoveMult = 1, mouseMovePwr = 1.5
+static const int accelCurve_m1_p1_5[ACCEL_TABLE_SIZE] = {
+    0, 256, 724, 1330, 2048, 2862, 3762, 4741, 5793, 6912, 8095, 9340, 10642, 11999, 13410, 14872,
+    16384, 17944, 19550, 21202, 22897, 24636, 26416, 28238, 30099, 32000, 33939, 35916, 37929, 39979, 42065, 44186,
+    46341, 48530, 50753, 53008, 55296, 57616, 59967, 62350, 64763, 67207, 69681, 72184, 74717, 77279, 79869, 82487,
+    85134, 87808, 90510, 93238, 95994, 98777, 101585, 104420, 107281, 110167, 113079, 116016, 118978, 121965, 124976, 128012,
+    131072, 134156, 137264, 140395, 143550, 146728, 149929, 153154, 156401, 159670, 162962, 166277, 169613, 172972, 176353, 179755,
+    183179, 186624, 190091, 193578, 197087, 200617, 204168, 207739, 211331, 214944, 218577, 222230, 225903, 229596, 233309, 237042,
+    240795, 244567, 248359, 252170, 256000, 259850, 263718, 267606, 271513, 275438, 279382, 283345, 287326, 291326, 295345, 299381,
+    303436, 307509, 311600, 315709, 319836, 323980, 328143, 332323, 336521, 340736, 344969, 349219, 353486, 357771, 362073, 366392,
+    370728, 375081, 379450, 383837, 388241, 392661, 397098, 401551, 406021, 410507, 415010, 419529, 424065, 428616, 433184, 437768,
+    442368, 446984, 451616, 456264, 460927, 465607, 470302, 475013, 479739, 484481, 489239, 494012, 498800, 503604, 508423, 513258,
+    518108, 522972, 527852, 532747, 537658, 542583, 547523, 552478, 557447, 562432, 567431, 572446, 577474, 582518, 587576, 592648,
+    597735, 602837, 607953, 613083, 618228, 623387, 628560, 633748, 638950, 644166, 649396, 654640, 659898, 665170, 670456, 675756,
+    681070, 686398, 691740, 697095, 702464, 707847, 713243, 718654, 724077, 729515, 734966, 740430, 745908, 751399, 756904, 762422,
+    767954, 773498, 779056, 784628, 790212, 795810, 801421, 807045, 812682, 818332, 823995, 829671, 835361, 841063, 846778, 852506,
+    858246, 864000, 869766, 875546, 881338, 887142, 892959, 898789, 904632, 910487, 916355, 922235, 928128, 934034, 939951, 945882,
+    951824, 957780, 963747, 969727, 975719, 981723, 987740, 993769, 999810, 1005863, 1011929, 1018006, 1024096, 1030198, 1036312, 1042438
+};
+
+//mouseMoveMult = 1, mouseMovePwr = 2
+static const int accelCurve_m1_p2_0[ACCEL_TABLE_SIZE] = {
+    0, 256, 1024, 2304, 4096, 6400, 9216, 12544, 16384, 20736, 25600, 30976, 36864, 43264, 50176, 57600,
+    65536, 73984, 82944, 92416, 102400, 112896, 123904, 135424, 147456, 160000, 173056, 186624, 200704, 215296, 230400, 246016,
+    262144, 278784, 295936, 313600, 331776, 350464, 369664, 389376, 409600, 430336, 451584, 473344, 495616, 518400, 541696, 565504,
+    589824, 614656, 640000, 665856, 692224, 719104, 746496, 774400, 802816, 831744, 861184, 891136, 921600, 952576, 984064, 1016064,
+    1048576, 1081600, 1115136, 1149184, 1183744, 1218816, 1254400, 1290496, 1327104, 1364224, 1401856, 1440000, 1478656, 1517824, 1557504, 1597696,
+    1638400, 1679616, 1721344, 1763584, 1806336, 1849600, 1893376, 1937664, 1982464, 2027776, 2073600, 2119936, 2166784, 2214144, 2262016, 2310400,
+    2359296, 2408704, 2458624, 2509056, 2560000, 2611456, 2663424, 2715904, 2768896, 2822400, 2876416, 2930944, 2985984, 3041536, 3097600, 3154176,
+    3211264, 3268864, 3326976, 3385600, 3444736, 3504384, 3564544, 3625216, 3686400, 3748096, 3810304, 3873024, 3936256, 4000000, 4064256, 4129024,
+    4194304, 4260096, 4326400, 4393216, 4460544, 4528384, 4596736, 4665600, 4734976, 4804864, 4875264, 4946176, 5017600, 5089536, 5161984, 5234944,
+    5308416, 5382400, 5456896, 5531904, 5607424, 5683456, 5760000, 5837056, 5914624, 5992704, 6071296, 6150400, 6230016, 6310144, 6390784, 6471936,
+    6553600, 6635776, 6718464, 6801664, 6885376, 6969600, 7054336, 7139584, 7225344, 7311616, 7398400, 7485696, 7573504, 7661824, 7750656, 7840000,
+    7929856, 8020224, 8111104, 8202496, 8294400, 8386816, 8479744, 8573184, 8667136, 8761600, 8856576, 8952064, 9048064, 9144576, 9241600, 9339136,
+    9437184, 9535744, 9634816, 9734400, 9834496, 9935104, 10036224, 10137856, 10240000, 10342656, 10445824, 10549504, 10653696, 10758400, 10863616, 10969344,
+    11075584, 11182336, 11289600, 11397376, 11505664, 11614464, 11723776, 11833600, 11943936, 12054784, 12166144, 12278016, 12390400, 12503296, 12616704, 12730624,
+    12845056, 12960000, 13075456, 13191424, 13307904, 13424896, 13542400, 13660416, 13778944, 13897984, 14017536, 14137600, 14258176, 14379264, 14500864, 14622976,
+    14745600, 14868736, 14992384, 15116544, 15241216, 15366400, 15492096, 15618304, 15745024, 15872256, 16000000, 16128256, 16257024, 16386304, 16516096, 16646400
+};
+
+//mouseMoveMult = 3, mouseMovePwr = 1
+static const int accelCurve_m3_p1_0[ACCEL_TABLE_SIZE] = {
+    0, 768, 1536, 2304, 3072, 3840, 4608, 5376, 6144, 6912, 7680, 8448, 9216, 9984, 10752, 11520,
+    12288, 13056, 13824, 14592, 15360, 16128, 16896, 17664, 18432, 19200, 19968, 20736, 21504, 22272, 23040, 23808,
+    24576, 25344, 26112, 26880, 27648, 28416, 29184, 29952, 30720, 31488, 32256, 33024, 33792, 34560, 35328, 36096,
+    36864, 37632, 38400, 39168, 39936, 40704, 41472, 42240, 43008, 43776, 44544, 45312, 46080, 46848, 47616, 48384,
+    49152, 49920, 50688, 51456, 52224, 52992, 53760, 54528, 55296, 56064, 56832, 57600, 58368, 59136, 59904, 60672,
+    61440, 62208, 62976, 63744, 64512, 65280, 66048, 66816, 67584, 68352, 69120, 69888, 70656, 71424, 72192, 72960,
+    73728, 74496, 75264, 76032, 76800, 77568, 78336, 79104, 79872, 80640, 81408, 82176, 82944, 83712, 84480, 85248,
+    86016, 86784, 87552, 88320, 89088, 89856, 90624, 91392, 92160, 92928, 93696, 94464, 95232, 96000, 96768, 97536,
+    98304, 99072, 99840, 100608, 101376, 102144, 102912, 103680, 104448, 105216, 105984, 106752, 107520, 108288, 109056, 109824,
+    110592, 111360, 112128, 112896, 113664, 114432, 115200, 115968, 116736, 117504, 118272, 119040, 119808, 120576, 121344, 122112,
+    122880, 123648, 124416, 125184, 125952, 126720, 127488, 128256, 129024, 129792, 130560, 131328, 132096, 132864, 133632, 134400,
+    135168, 135936, 136704, 137472, 138240, 139008, 139776, 140544, 141312, 142080, 142848, 143616, 144384, 145152, 145920, 146688,
+    147456, 148224, 148992, 149760, 150528, 151296, 152064, 152832, 153600, 154368, 155136, 155904, 156672, 157440, 158208, 158976,
+    159744, 160512, 161280, 162048, 162816, 163584, 164352, 165120, 165888, 166656, 167424, 168192, 168960, 169728, 170496, 171264,
+    172032, 172800, 173568, 174336, 175104, 175872, 176640, 177408, 178176, 178944, 179712, 180480, 181248, 182016, 182784, 183552,
+    184320, 185088, 185856, 186624, 187392, 188160, 188928, 189696, 190464, 191232, 192000, 192768, 193536, 194304, 195072, 195840
+};
+
+#define ACCEL_CURVE_COUNT 5
+
+static const int *const accelCurves[ACCEL_CURVE_COUNT] = {
+    accelCurve_m1_p1_0,
+    accelCurve_m1_p1_2,
+    accelCurve_m1_p1_5,
+    accelCurve_m1_p2_0,
+    accelCurve_m3_p1_0
+};
+
+#endif
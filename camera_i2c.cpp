@@ -0,0 +1,211 @@
+#include "mbed.h"
+#include "camera_i2c.h"
+
+//I2CONSET / I2CONCLR bits
+#define I2C_AA   0x04
+#define I2C_SI   0x08
+#define I2C_STO  0x10
+#define I2C_STA  0x20
+#define I2C_EN   0x40
+
+//register to request the point data from
+#define CAMERA_DATA_REG 0x36
+
+//where the transfer is at
+enum CameraBusPhase {
+    PHASE_IDLE,
+    PHASE_WRITE_REG,  //sending 0x36
+    PHASE_READ_DATA,  //reading the 16 byte report
+    PHASE_WRITE_CFG   //sending a setup write from cameraStartWrite()
+};
+
+static LPC_I2C_TypeDef *bus = LPC_I2C1;
+static char busAddress;
+static void (*frameCallback)(void) = NULL;
+
+//two frame buffers: one is being filled by the interrupt, the other
+//holds the last completed frame until it is taken
+static char frameBuf[2][CAMERA_FRAME_SIZE];
+static unsigned int frameStampUs[2];
+static volatile int fillIndex = 0;
+static volatile int readyIndex = 1;
+static volatile bool frameReady = false;
+
+static volatile CameraBusPhase phase = PHASE_IDLE;
+static volatile int rxCount = 0;
+
+//pending setup write
+static char writeBuf[CAMERA_WRITE_MAX];
+static volatile int writeLen = 0;
+static volatile int txCount = 0;
+
+volatile unsigned int cameraFramesDropped = 0;
+volatile unsigned int cameraReadsSkipped = 0;
+volatile unsigned int cameraBusErrors = 0;
+
+
+//give up on the current transfer and release the bus
+static void abortTransfer(void){
+    bus->I2CONSET = I2C_STO;
+    bus->I2CONCLR = I2C_STA | I2C_SI;
+    phase = PHASE_IDLE;
+    cameraBusErrors++;
+}
+
+
+//frame finished, hand the buffer over and start filling the other one
+static void publishFrame(void){
+    if(frameReady){
+        //previous frame was never taken
+        cameraFramesDropped++;
+    }
+    frameStampUs[fillIndex] = us_ticker_read();
+    readyIndex = fillIndex;
+    fillIndex = 1 - fillIndex;
+    frameReady = true;
+    phase = PHASE_IDLE;
+
+    if(frameCallback){
+        frameCallback();
+    }
+}
+
+
+//I2C1 interrupt, one call per bus state change
+//status codes are from the LPC176x user manual (master tx/rx modes)
+static void cameraI2CIrq(void){
+    switch(bus->I2STAT){
+        case 0x08: //START sent
+            if(phase == PHASE_WRITE_REG || phase == PHASE_WRITE_CFG){
+                bus->I2DAT = busAddress;
+            } else {
+                bus->I2DAT = busAddress | 0x01;
+            }
+            bus->I2CONCLR = I2C_STA | I2C_SI;
+            break;
+
+        case 0x18: //SLA+W sent, ACK
+            if(phase == PHASE_WRITE_CFG){
+                txCount = 0;
+                bus->I2DAT = writeBuf[txCount++];
+            } else {
+                bus->I2DAT = CAMERA_DATA_REG;
+            }
+            bus->I2CONCLR = I2C_SI;
+            break;
+
+        case 0x28: //register byte sent, ACK
+            if(phase == PHASE_WRITE_CFG){
+                if(txCount < writeLen){
+                    bus->I2DAT = writeBuf[txCount++];
+                } else {
+                    //setup write done, nothing to publish
+                    bus->I2CONSET = I2C_STO;
+                    phase = PHASE_IDLE;
+                }
+                bus->I2CONCLR = I2C_SI;
+                break;
+            }
+
+            //STOP followed by a fresh START, same as the old
+            //write() then read() sequence
+            phase = PHASE_READ_DATA;
+            bus->I2CONSET = I2C_STO | I2C_STA;
+            bus->I2CONCLR = I2C_SI;
+            break;
+
+        case 0x40: //SLA+R sent, ACK
+            rxCount = 0;
+            bus->I2CONSET = I2C_AA;
+            bus->I2CONCLR = I2C_SI;
+            break;
+
+        case 0x50: //data byte received, ACK returned
+            frameBuf[fillIndex][rxCount++] = bus->I2DAT;
+            if(rxCount >= CAMERA_FRAME_SIZE - 1){
+                //NACK the last byte
+                bus->I2CONCLR = I2C_AA;
+            }
+            bus->I2CONCLR = I2C_SI;
+            break;
+
+        case 0x58: //last byte received, NACK returned
+            frameBuf[fillIndex][rxCount++] = bus->I2DAT;
+            bus->I2CONSET = I2C_STO;
+            bus->I2CONCLR = I2C_SI;
+            publishFrame();
+            break;
+
+        default: //0x20, 0x30, 0x48 NACKs, 0x38 arbitration lost, 0x00 bus error
+            abortTransfer();
+            break;
+    }
+}
+
+
+void cameraI2CInit(int address, void (*onFrame)(void)){
+    busAddress = address & 0xFE;
+    frameCallback = onFrame;
+    phase = PHASE_IDLE;
+
+    //camera1 already set up pins, clock and I2EN, only hook the interrupt
+    //(the camera register setup goes through cameraStartWrite())
+    bus->I2CONCLR = I2C_AA | I2C_SI | I2C_STA;
+    NVIC_SetVector(I2C1_IRQn, (uintptr_t)&cameraI2CIrq);
+    NVIC_EnableIRQ(I2C1_IRQn);
+}
+
+
+bool cameraStartRead(void){
+    if(phase != PHASE_IDLE){
+        cameraReadsSkipped++;
+        return false;
+    }
+
+    phase = PHASE_WRITE_REG;
+    bus->I2CONSET = I2C_EN | I2C_STA;
+    return true;
+}
+
+
+bool cameraStartWrite(const char *data, int len){
+    if(phase != PHASE_IDLE || len < 1 || len > CAMERA_WRITE_MAX){
+        return false;
+    }
+
+    memcpy(writeBuf, data, len);
+    writeLen = len;
+    phase = PHASE_WRITE_CFG;
+    bus->I2CONSET = I2C_EN | I2C_STA;
+    return true;
+}
+
+
+bool cameraBusIdle(void){
+    return phase == PHASE_IDLE;
+}
+
+
+bool cameraFrameReady(void){
+    return frameReady;
+}
+
+
+bool cameraTakeFrame(char dest[CAMERA_FRAME_SIZE], unsigned int *stampUs){
+    bool taken = false;
+
+    //short critical section so the interrupt cannot publish into
+    //readyIndex halfway through the copy
+    core_util_critical_section_enter();
+    if(frameReady){
+        memcpy(dest, frameBuf[readyIndex], CAMERA_FRAME_SIZE);
+        if(stampUs){
+            *stampUs = frameStampUs[readyIndex];
+        }
+        frameReady = false;
+        taken = true;
+    }
+    core_util_critical_section_exit();
+
+    return taken;
+}
@@ -0,0 +1,58 @@
+#ifndef CAMERA_I2C_H
+#define CAMERA_I2C_H
+
+#include <stddef.h>
+
+//******************************************************************
+// Interrupt driven reads from the wiimote camera
+//******************************************************************
+//
+// drives the LPC176x I2C1 peripheral (p9, p10) from its own interrupt
+// instead of blocking in camera1.read()/write(). the ticker only kicks
+// off a transfer, the I2C interrupt walks through the bus states and
+// the finished 16 byte frame is published into one of two buffers.
+//
+// NOTE: the target does not enable DEVICE_I2C_ASYNCH so I2C::transfer
+//       is not available, this talks to the registers directly
+
+//bytes in one extended mode report (including the leading status byte)
+#define CAMERA_FRAME_SIZE 16
+
+//longest write cameraStartWrite() takes
+#define CAMERA_WRITE_MAX 2
+
+//takes over I2C1, camera1 only sets up the pins and clock
+//address is the 8 bit (write) address, same as used with camera1
+//onFrame (if given) is called from the interrupt whenever a frame
+//has been published
+void cameraI2CInit(int address, void (*onFrame)(void) = NULL);
+
+//starts reading one frame in the background
+//returns false if the previous transfer has not finished yet
+bool cameraStartRead(void);
+
+//starts writing len bytes (register, value) to the camera in the
+//background, used by camera_init.cpp for the setup sequence
+//returns false if the bus is busy or len is out of range
+//a NACK shows up as a cameraBusErrors increment
+bool cameraStartWrite(const char *data, int len);
+
+//true if no read or write is in flight
+bool cameraBusIdle(void);
+
+//true if a completed frame is waiting to be taken
+bool cameraFrameReady(void);
+
+//copies the newest completed frame into dest and clears the ready flag
+//stampUs (if given) gets the us_ticker_read() time the read completed
+//returns false if no frame was waiting
+bool cameraTakeFrame(char dest[CAMERA_FRAME_SIZE], unsigned int *stampUs = NULL);
+
+//counters for frames that were overwritten before being taken, reads
+//that were skipped because the bus was still busy, and NACK/arbitration
+//errors on the bus
+extern volatile unsigned int cameraFramesDropped;
+extern volatile unsigned int cameraReadsSkipped;
+extern volatile unsigned int cameraBusErrors;
+
+#endif
@@ -0,0 +1,79 @@
+#include "mbed.h"
+#include "camera_init.h"
+#include "camera_i2c.h"
+
+//longest sequence that can be queued
+#define CAMERA_INIT_MAX_STEPS 16
+
+static CameraInitStep sequence[CAMERA_INIT_MAX_STEPS];
+static int sequenceLength = 0;
+static void (*readyCallback)(void) = NULL;
+
+static Timeout stepTimeout;
+
+//next write to send, sequenceLength once everything went out
+static volatile int stepIndex = 0;
+static volatile bool initDone = false;
+
+//cameraBusErrors when the current write was started
+static unsigned int errorsAtWrite = 0;
+
+volatile unsigned int cameraInitRuns = 0;
+volatile unsigned int cameraInitRetries = 0;
+
+
+//runs every CAMERA_INIT_STEP_US until the sequence is through
+static void cameraInitStep(void){
+    //last write was NACKed, the camera is not there (yet)
+    if(cameraBusErrors != errorsAtWrite){
+        cameraInitRetries++;
+        stepIndex = 0;
+        errorsAtWrite = cameraBusErrors;
+        stepTimeout.attach_us(&cameraInitStep, CAMERA_INIT_RETRY_US);
+        return;
+    }
+
+    if(stepIndex >= sequenceLength){
+        initDone = true;
+        if(readyCallback){
+            readyCallback();
+        }
+        return;
+    }
+
+    //a frame read still finishing (re-init while running), try again
+    //on the next step
+    char out[2];
+    out[0] = sequence[stepIndex].reg;
+    out[1] = sequence[stepIndex].value;
+    if(cameraStartWrite(out, 2)){
+        stepIndex++;
+    }
+
+    stepTimeout.attach_us(&cameraInitStep, CAMERA_INIT_STEP_US);
+}
+
+
+void cameraInitStart(const CameraInitStep *steps, int count, void (*onReady)(void)){
+    if(count > CAMERA_INIT_MAX_STEPS){
+        count = CAMERA_INIT_MAX_STEPS;
+    }
+
+    stepTimeout.detach();
+    for(int i = 0; i < count; i++){
+        sequence[i] = steps[i];
+    }
+    sequenceLength = count;
+    readyCallback = onReady;
+    stepIndex = 0;
+    initDone = false;
+    errorsAtWrite = cameraBusErrors;
+    cameraInitRuns++;
+
+    cameraInitStep();
+}
+
+
+bool cameraInitDone(void){
+    return initDone;
+}
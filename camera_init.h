@@ -0,0 +1,44 @@
+#ifndef CAMERA_INIT_H
+#define CAMERA_INIT_H
+
+//******************************************************************
+// Non-blocking camera bring-up
+//******************************************************************
+//
+// the register setup used to be nine blocking write2bytes() calls with
+// a wait(0.01) after each. it is now a small state machine on a
+// Timeout: one write goes out through camera_i2c.cpp every
+// CAMERA_INIT_STEP_US and the rest of the system keeps running in
+// between. the same sequence can be started again at runtime to
+// re-init a camera that stopped answering.
+
+//settle time after each register write, same as the old wait(0.01)
+#define CAMERA_INIT_STEP_US 10000
+
+//back off before starting over after a write was NACKed
+#define CAMERA_INIT_RETRY_US 100000
+
+//one register write of the sequence
+struct CameraInitStep {
+    char reg;
+    char value;
+};
+
+//starts (or restarts) the setup sequence, steps is copied so it can
+//live on the stack. frame reads must wait until cameraInitDone()
+//not reentrant, and the step Timeout runs it too: start it from setup
+//(before the tickers) or from a ticker interrupt, never from the main
+//loop while the sequence may be running
+//onReady (if given) is called from the Timeout once the last write
+//has settled
+void cameraInitStart(const CameraInitStep *steps, int count, void (*onReady)(void) = NULL);
+
+//true once the sequence has gone through
+bool cameraInitDone(void);
+
+//number of times the sequence has been started, and restarted after
+//a NACK
+extern volatile unsigned int cameraInitRuns;
+extern volatile unsigned int cameraInitRetries;
+
+#endif
@@ -0,0 +1,112 @@
+#include <algorithm>
+#include "contacts.h"
+#include "profiler.h"
+
+struct Contact {
+    IRPoint point;
+    bool used;              //slot holds a contact (confirmed or not)
+    unsigned char seen;     //frames seen, up to CONTACT_BIRTH_FRAMES
+    unsigned char missed;   //frames missed in a row
+};
+
+static Contact contacts[IR_MAX_POINTS];
+
+//cost of leaving a contact or a blob unpaired, anything costing more
+//than this is never paired
+static const int UNMATCHED_COST = CONTACT_MATCH_GATE * CONTACT_MATCH_GATE;
+
+
+static int distanceSq(const IRPoint &a, const IRPoint &b){
+    int dx = a.x - b.x;
+    int dy = a.y - b.y;
+    return dx * dx + dy * dy;
+}
+
+
+void matchContacts(const IRFrame &raw, IRFrame &out){
+    PROFILE_SCOPE(PROF_CONTACTS);
+    //try every pairing of contact slot -> blob slot, 4! = 24 of them
+    //perm[i] is the blob contact i would take
+    int perm[IR_MAX_POINTS];
+    int best[IR_MAX_POINTS];
+    int bestCost = -1;
+    for(int i = 0; i < IR_MAX_POINTS; i++){
+        perm[i] = i;
+    }
+
+    do {
+        int cost = 0;
+        for(int i = 0; i < IR_MAX_POINTS; i++){
+            bool haveContact = contacts[i].used;
+            bool haveBlob = irPointValid(raw, perm[i]);
+            if(haveContact && haveBlob){
+                int d = distanceSq(contacts[i].point, raw.point[perm[i]]);
+                //past the gate it is cheaper to end one and start another
+                cost += (d < 2 * UNMATCHED_COST) ? d : 2 * UNMATCHED_COST;
+            } else if(haveContact || haveBlob){
+                cost += UNMATCHED_COST;
+            }
+        }
+        if(bestCost < 0 || cost < bestCost){
+            bestCost = cost;
+            for(int i = 0; i < IR_MAX_POINTS; i++){
+                best[i] = perm[i];
+            }
+        }
+    } while(std::next_permutation(perm, perm + IR_MAX_POINTS));
+
+    //carry matched contacts on, age the unmatched ones
+    unsigned char blobsTaken = 0;
+    for(int i = 0; i < IR_MAX_POINTS; i++){
+        Contact &c = contacts[i];
+        if(!c.used){
+            continue;
+        }
+
+        int b = best[i];
+        if(irPointValid(raw, b) && distanceSq(c.point, raw.point[b]) <= UNMATCHED_COST){
+            c.point = raw.point[b];
+            c.missed = 0;
+            if(c.seen < CONTACT_BIRTH_FRAMES){
+                c.seen++;
+            }
+            blobsTaken |= 1 << b;
+        } else if(c.seen < CONTACT_BIRTH_FRAMES || ++c.missed > CONTACT_DEATH_FRAMES){
+            //never confirmed, or gone for too long
+            c.used = false;
+        }
+    }
+
+    //leftover blobs start new contacts in the lowest free IDs
+    for(int b = 0; b < IR_MAX_POINTS; b++){
+        if(!irPointValid(raw, b) || ((blobsTaken >> b) & 1)){
+            continue;
+        }
+        for(int i = 0; i < IR_MAX_POINTS; i++){
+            if(!contacts[i].used){
+                contacts[i].used = true;
+                contacts[i].point = raw.point[b];
+                contacts[i].seen = 1;
+                contacts[i].missed = 0;
+                break;
+            }
+        }
+    }
+
+    clearIRFrame(out);
+    for(int i = 0; i < IR_MAX_POINTS; i++){
+        if(contacts[i].used && contacts[i].seen >= CONTACT_BIRTH_FRAMES){
+            out.point[i] = contacts[i].point;
+            out.valid |= 1 << i;
+        }
+    }
+}
+
+
+void resetContacts(void){
+    for(int i = 0; i < IR_MAX_POINTS; i++){
+        contacts[i].used = false;
+        contacts[i].seen = 0;
+        contacts[i].missed = 0;
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef CONTACTS_H
+#define CONTACTS_H
+
+#include "ir_frame.h"
+
+//******************************************************************
+// Stable contact IDs across frames
+//******************************************************************
+//
+// the camera does not keep its slot order: when a blob shows up or
+// goes away the others can move to different slots. matchContacts()
+// pairs the blobs of each frame with the contacts of the last one
+// (minimum total distance over all pairings) so slot i of its output
+// is always the same finger.
+
+//furthest a contact can move between frames and still be matched,
+//in camera counts (further is a new contact)
+const short CONTACT_MATCH_GATE = 150;
+
+//frames a new blob has to be seen before it is reported
+const unsigned char CONTACT_BIRTH_FRAMES = 2;
+
+//frames a reported contact can go missing before it is dropped, it
+//holds its last position in between
+const unsigned char CONTACT_DEATH_FRAMES = 2;
+
+//matches the decoded camera frame against the current contacts
+//contacts gets the points indexed by contact ID, valid only for
+//contacts that made it through the birth hysteresis
+void matchContacts(const IRFrame &raw, IRFrame &contacts);
+
+void resetContacts(void);
+
+#endif
@@ -0,0 +1,45 @@
+#include "mbed.h"
+#include "event_queue.h"
+#include "lockfree_buffer.h"
+
+//one consumer (main loop) but several producers (interrupts at
+//different priorities), so pushes are serialized with a very short
+//critical section, pops need none
+static LockFreeCircularBuffer<unsigned char, EVENT_QUEUE_SIZE> events;
+
+volatile unsigned int eventOverflows = 0;
+volatile unsigned int eventHighWater = 0;
+
+
+bool postEvent(GhostEvent event){
+    core_util_critical_section_enter();
+    bool posted = events.push((unsigned char)event);
+    if(!posted){
+        eventOverflows++;
+    } else if(events.size() > eventHighWater){
+        eventHighWater = events.size();
+    }
+    core_util_critical_section_exit();
+
+    return posted;
+}
+
+
+bool takeEvent(GhostEvent &event){
+    unsigned char e;
+    if(!events.pop(e)){
+        return false;
+    }
+    event = (GhostEvent)e;
+    return true;
+}
+
+
+bool eventsPending(void){
+    return !events.empty();
+}
+
+
+void resetEvents(void){
+    events.reset();
+}
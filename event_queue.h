@@ -0,0 +1,44 @@
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+
+//******************************************************************
+// Run to completion event queue
+//******************************************************************
+//
+// interrupts only post events, the main loop takes them off one at a
+// time and runs the matching handler to completion. handlers never
+// preempt each other, so the pipeline state needs no locking.
+
+//events posted from interrupt context
+enum GhostEvent {
+    EVENT_CAMERA_FRAME,   //camera finished a frame, process it
+    EVENT_MOUSE_TICK,     //time to send the mouse state
+    EVENT_PC_COMMAND,     //key received on pc
+#ifdef GHOST_PROFILE
+    EVENT_PROFILE_DUMP,   //print the stage timings
+#endif
+    EVENT_COUNT
+};
+
+//queued events, has to be a power of two
+#define EVENT_QUEUE_SIZE 16
+
+//interrupt side, safe from any interrupt priority
+//returns false (and counts an overflow) if the queue is full
+bool postEvent(GhostEvent event);
+
+//main loop side
+//returns false if nothing is waiting
+bool takeEvent(GhostEvent &event);
+
+//true if an event is waiting, checked with interrupts off before the
+//main loop goes to sleep
+bool eventsPending(void);
+
+//clears the queue, only while interrupts are not posting
+void resetEvents(void);
+
+extern volatile unsigned int eventOverflows;
+extern volatile unsigned int eventHighWater;
+
+#endif
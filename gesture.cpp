@@ -0,0 +1,124 @@
+#include <stdlib.h>
+#include "gesture.h"
+
+int tapDeadZone = TAP_DEAD_ZONE;
+int tapMinFrames = TAP_MIN_FRAMES;
+int tapMaxFrames = TAP_MAX_FRAMES;
+
+static const GestureStateInfo stateInfo[GESTURE_STATE_COUNT] = {
+    {"idle",  NULL},
+    {"touch", &tapMaxFrames},
+    {"point", NULL},
+};
+
+//[state][event]
+static const GestureTransition transitions[GESTURE_STATE_COUNT][GESTURE_EVENT_COUNT] = {
+    //GESTURE_IDLE
+    {
+        {GESTURE_IDLE,  GACT_NONE},     //GEV_ABSENT
+        {GESTURE_TOUCH, GACT_LAND},     //GEV_STILL
+        {GESTURE_TOUCH, GACT_LAND},     //GEV_MOVED
+        {GESTURE_IDLE,  GACT_NONE},     //GEV_TIMEOUT
+        {GESTURE_POINT, GACT_NONE},     //GEV_CANCEL
+    },
+    //GESTURE_TOUCH
+    {
+        {GESTURE_IDLE,  GACT_TAP},      //GEV_ABSENT
+        {GESTURE_TOUCH, GACT_NONE},     //GEV_STILL
+        {GESTURE_POINT, GACT_NONE},     //GEV_MOVED
+        {GESTURE_POINT, GACT_NONE},     //GEV_TIMEOUT, held too long for a tap
+        {GESTURE_POINT, GACT_NONE},     //GEV_CANCEL
+    },
+    //GESTURE_POINT
+    {
+        {GESTURE_IDLE,  GACT_NONE},     //GEV_ABSENT
+        {GESTURE_POINT, GACT_NONE},     //GEV_STILL
+        {GESTURE_POINT, GACT_NONE},     //GEV_MOVED
+        {GESTURE_POINT, GACT_NONE},     //GEV_TIMEOUT
+        {GESTURE_POINT, GACT_NONE},     //GEV_CANCEL
+    },
+};
+
+static GestureState state = GESTURE_IDLE;
+
+//frames spent in the current state
+static short stateFrames = 0;
+
+//where the finger landed
+static short baseX = 0;
+static short baseY = 0;
+
+//frame the event came from, for the actions that need it
+static const IRPoint *eventPoint = NULL;
+
+
+static int runAction(GestureAction action){
+    switch(action){
+        case GACT_LAND:
+            baseX = eventPoint->x;
+            baseY = eventPoint->y;
+            return 0;
+
+        case GACT_TAP:
+            //stateFrames still counts the touch. a touch that reached
+            //tapMaxFrames has timed out, unless it lifts on that very
+            //frame: ABSENT is checked before the timeout
+            if(stateFrames > tapMinFrames && stateFrames < tapMaxFrames){
+                return GESTURE_OUT_TAP;
+            }
+            return 0;
+
+        case GACT_NONE:
+        default:
+            return 0;
+    }
+}
+
+
+int gestureEvent(GestureEvent event){
+    const GestureTransition &t = transitions[state][event];
+    int out = runAction(t.action);
+
+    if(t.next != state){
+        state = t.next;
+        stateFrames = 0;
+    } else if(stateFrames < 0x7FFF){
+        stateFrames++;
+    }
+    return out;
+}
+
+
+int updateGesture(const IRFrame &curr, int finger){
+    GestureEvent event;
+    eventPoint = &curr.point[finger];
+
+    if(!irPointValid(curr, finger)){
+        event = GEV_ABSENT;
+    } else if(abs(eventPoint->x - baseX) >= tapDeadZone || abs(eventPoint->y - baseY) >= tapDeadZone){
+        event = GEV_MOVED;
+    } else if(stateInfo[state].timeoutFrames && stateFrames >= *stateInfo[state].timeoutFrames){
+        event = GEV_TIMEOUT;
+    } else {
+        event = GEV_STILL;
+    }
+
+    return gestureEvent(event);
+}
+
+
+GestureState gestureState(void){
+    return state;
+}
+
+
+const char *gestureStateName(GestureState s){
+    return stateInfo[s].name;
+}
+
+
+void resetGesture(void){
+    state = GESTURE_IDLE;
+    stateFrames = 0;
+    eventPoint = NULL;
+}
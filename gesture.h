@@ -0,0 +1,83 @@
+#ifndef GESTURE_H
+#define GESTURE_H
+
+#include "ir_frame.h"
+
+//******************************************************************
+// Tap recognition as a table driven state machine
+//******************************************************************
+//
+// each frame is turned into one GestureEvent, the transition table
+// gives the next state and the action to run, and the actions are a
+// single switch (a jump table). the timing thresholds sit in the
+// state table, so a new gesture is a new state, a row in each table
+// and maybe an action, without touching the existing rows.
+
+enum GestureState {
+    GESTURE_IDLE,       //no finger
+    GESTURE_TOUCH,      //finger down and still, could become a tap
+    GESTURE_POINT,      //finger down and moving the pointer
+    GESTURE_STATE_COUNT
+};
+
+enum GestureEvent {
+    GEV_ABSENT,         //no finger this frame
+    GEV_STILL,          //finger within TAP_DEAD_ZONE of where it landed
+    GEV_MOVED,          //finger further out than that
+    GEV_TIMEOUT,        //finger still, but past the state's timeout
+    GEV_CANCEL,         //another gesture (two finger scroll) took over
+    GESTURE_EVENT_COUNT
+};
+
+enum GestureAction {
+    GACT_NONE,
+    GACT_LAND,          //remember where the finger landed
+    GACT_TAP,           //finger lifted, tap if it was down long enough
+    GESTURE_ACTION_COUNT
+};
+
+struct GestureTransition {
+    GestureState next;
+    GestureAction action;
+};
+
+struct GestureStateInfo {
+    const char *name;
+    const int *timeoutFrames;   //frames before GEV_TIMEOUT, NULL for never
+};
+
+//camera counts a tap can wander from where it landed
+const short TAP_DEAD_ZONE = 50;
+
+//frames a tap has to last (more than min, less than max)
+const short TAP_MIN_FRAMES = 10;
+const short TAP_MAX_FRAMES = 50;
+
+//the values in use, start out at the defaults above and can be
+//changed at runtime (pc shell)
+extern int tapDeadZone;
+extern int tapMinFrames;
+extern int tapMaxFrames;
+
+//what updateGesture() found this frame
+#define GESTURE_OUT_TAP 0x01
+
+//runs one frame of contact finger through the machine
+//returns GESTURE_OUT_* bits
+int updateGesture(const IRFrame &curr, int finger);
+
+//feeds an event that does not come from the frame (GEV_CANCEL)
+int gestureEvent(GestureEvent event);
+
+GestureState gestureState(void);
+
+//true while a possible tap holds the pointer still
+inline bool gestureTouching(void){
+    return gestureState() == GESTURE_TOUCH;
+}
+
+const char *gestureStateName(GestureState state);
+
+void resetGesture(void);
+
+#endif
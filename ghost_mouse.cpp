@@ -0,0 +1,1035 @@
+#include "mbed.h"
+#include <RawSerial.h>
+#include "ghost_mouse.h"
+#include "camera_i2c.h"
+#include "camera_init.h"
+#include "hid_tx.h"
+#include "ir_frame.h"
+#include "accel.h"
+#include "event_queue.h"
+#include "profiler.h"
+#include "latency.h"
+#include "scroll.h"
+#include "kalman.h"
+#include "contacts.h"
+#include "one_euro.h"
+#include "gesture.h"
+#include "motion_channel.h"
+#include "scheduler.h"
+#include "idle.h"
+#include "telemetry.h"
+#include "recorder.h"
+#include "shell.h"
+//#include <math.h>
+
+//******************************************************************
+// All variables defined below
+//******************************************************************
+
+//communication
+DigitalOut myled(LED1);
+RawSerial pc(USBTX, USBRX);
+RawSerial keyOut(p13, p14);
+I2C camera1(p9, p10);
+
+
+//initial camera data
+int IRsensorAddress = 0xB0;
+int slaveAddress;
+char data_buf[16];
+
+//sensitivity
+//Level 5: p0 = 0x96, p1 = 0xFE, p2 = 0xFE, p3 = 0x05
+//highest sensitivity to more accurately detect points
+//initCamera() only writes sen1..sen3, sen0 is not sent
+int sen0 = 0x96;
+int sen1 = 0xFE;
+int sen2 = 0xFE;
+int sen3 = 0x00;
+
+//the four slots as the camera sent them
+IRFrame rawFrame;
+
+//all four points from the first camera, current and previous frame,
+//indexed by contact ID so a slot is the same finger in both
+IRFrame irFrame;
+IRFrame prevIRFrame;
+
+//same points after the predictive tracker, these drive the pointer
+TrackedFrame trackedFrame;
+TrackedFrame prevTrackedFrame;
+
+//movement
+//motion is carried in fixed point from the tracker to the report,
+//MOTION_ONE is one camera count (before acceleration) or one report
+//count (after)
+#if TRACK_FRAC_BITS != ACCEL_FRAC_BITS
+#error tracker and acceleration table have to use the same fixed point
+#endif
+const int MOTION_ONE = 1 << ACCEL_FRAC_BITS;
+//the old per frame deadzone threw away a count of every frame's
+//motion, slow movement never got through. jitter is now taken out by
+//the tracker and by the report carry (a remainder has to reach a whole
+//count either way before anything is sent)
+//mouseMoveMult and mouseMovePwr now live in accel_table.h as lookup
+//tables, mouseMoveMult 1 for accumulation, 3 for no accum
+//MOVEMENT_CAP is gone, jumps now restart the track in kalman.cpp
+//(trackGate) instead of being clamped
+const short VALUES_TO_TOSS = 6;
+short tossedValuesCounter = VALUES_TO_TOSS;
+
+//click state
+//CLICK_DEAD_ZONE and the click durations are tapDeadZone and
+//tapMin/MaxFrames in gesture.h now, the state lives in gesture.cpp
+
+
+
+//MOUSE STATE
+//updated on the emit phase of the scheduler (scheduler.h), every
+//SCHED_REPORT_PERIOD_US right after the frame that completes it
+//what the frame being processed adds up to, motion in MOTION_ONE
+//units. posted to the motion channel at the end of readCameraData()
+int updatex[4];
+int updatey[4];
+short updateWheel = 0;
+short updatePan = 0;
+bool toLeftClick = false;
+bool toRightClick = false;
+
+//report side only: the part of the accelerated motion that was less
+//than a whole count (or did not fit) last tick, and the same for the
+//scroll and taps
+int carryX = 0;
+int carryY = 0;
+short carryWheel = 0;
+short carryPan = 0;
+int tapsToSend = 0;
+
+//BUTTONS
+//what the host has pressed right now (last report sent), and the
+//button states still to be reported, in order
+char mouseButtons = 0;
+const int BUTTON_QUEUE_SIZE = 4;
+char buttonQueue[BUTTON_QUEUE_SIZE];
+int buttonQueueLength = 0;
+
+//reports one tick may send for motion alone, 4 * 127 counts per 50 ms
+//before the rest waits for the next tick
+const int MAX_REPORTS_PER_TICK = 4;
+
+//LATENCY
+//us_ticker_read() time of the frame being processed, travels with its
+//motion through the channel
+unsigned int frameStampUs = 0;
+
+//TELEMETRY
+//gesture state of the last frame, a change is sent as a record
+GestureState lastGestureState = GESTURE_IDLE;
+
+
+
+//READING FROM CAMERA VIA INTERRUPT
+//started by the capture phase of the scheduler
+
+//bus errors since the last good frame before the camera is set up
+//again, and the count at that frame
+const unsigned int CAMERA_REINIT_ERRORS = 20;
+unsigned int errorsAtLastFrame = 0;
+
+//set from the main loop, the capture ticker does the restart so the
+//init sequence is only ever started from one context
+volatile bool cameraRestartPending = false;
+
+
+//BOOT TIMING
+//us_ticker_read() at the start of setup and the times (from there)
+//the camera came up, the first frame arrived and the first report
+//after it was queued, BOOT_NOT_YET until they happen
+#define BOOT_NOT_YET 0xFFFFFFFF
+unsigned int bootStartUs = 0;
+volatile unsigned int bootCameraReadyUs = BOOT_NOT_YET;
+unsigned int bootFirstFrameUs = BOOT_NOT_YET;
+unsigned int bootFirstReportUs = BOOT_NOT_YET;
+
+
+//PC COMMANDS
+//lines typed on pc go to the shell (shell.h), the tables are at
+//SHELL COMMANDS below
+//lines ignored because telemetry had the port
+unsigned int pcLinesMuted = 0;
+
+
+#ifdef GHOST_PROFILE
+//PROFILING
+//stage timings go out over pc every few seconds
+Ticker profileDumpTicker;
+const float PROFILE_DUMP_PERIOD = 5.0;
+#endif
+
+
+//LED
+DigitalOut myled2(LED2);
+
+
+
+//******************************************************************
+// All methods defined below
+//******************************************************************
+
+//takes in values for the movement in the x and y direction 
+//also can indicate whether you want to "click"
+//wheel/pan are whole scroll ticks, sent as is
+//stampUs is the frame time the report's latency is measured from
+//returns false if the TX queue was full and the report not sent
+bool mouseCommand(char buttons, short x, short y, short wheel, short pan, unsigned int stampUs) {
+  PROFILE_SCOPE(PROF_MOUSE_COMMAND);
+  
+  
+  //x = rint((x > 0) ? powf(mouseMoveMult*( (float) x) , mouseMovePwr) : -powf(-mouseMoveMult*( (float) x) , mouseMovePwr));
+//  y = rint((y > 0) ? powf(mouseMoveMult*( (float) y) , mouseMovePwr) : -powf(-mouseMoveMult*( (float) y) , mouseMovePwr));
+
+  //x = mouseMoveMult * ((x > 0) ? powf(( (float) x) , mouseMovePwr) : -powf(-( (float) x) , mouseMovePwr));
+  //y = mouseMoveMult * ((y > 0) ? powf(( (float) y) , mouseMovePwr) : -powf(-( (float) y) , mouseMovePwr));
+  
+  //same curve, looked up instead of two powf calls per report
+  //(now applied in updateMouseState() before the sub-count carry)
+  
+  //report fields are signed bytes, anything past +-127 would wrap
+  //and reverse direction. sendMouseReports() splits bigger motion over
+  //several reports, this is only the last line of defence
+  x = saturateReport(x);
+  y = saturateReport(y);
+  
+ // pc.printf("%hd   ", x);
+ // pc.printf("%hd\n", y);
+  
+//  x = (x > 0) ? powf(( (float) x) , mouseMovePwr) : -powf(-( (float) x) , mouseMovePwr);
+//  y = (y > 0) ? powf(( (float) y) , mouseMovePwr) : -powf(-( (float) y) , mouseMovePwr);
+  
+  
+  //x = mouseMoveMult*x;
+  //y = mouseMoveMult*y;
+  
+  //scroll fields are signed bytes
+  wheel = saturateReport(wheel);
+  pan = saturateReport(pan);
+  
+  
+  //x = x*abs(x);
+  //y = y*abs(y);
+    
+  //x = x*sqrt((float)abs(x));
+  //y = y*sqrt((float)abs(y));
+  
+  //raw mouse report for the RN-42
+  //queued for the TX interrupt, returns right away
+  char report[9];
+  report[0] = 0xFD;
+  report[1] = 0x00;
+  report[2] = 0x03;
+  report[3] = buttons;
+  report[4] = x;
+  report[5] = y;
+  report[6] = wheel;
+  report[7] = pan; //only used if the RN-42 descriptor has AC pan
+  report[8] = 0x00;
+  if(!hidTxWrite(report, 9, stampUs)){
+      return false;
+  }
+  //stamped like the latency record, with the frame behind the report
+  telemetryReport(buttons, x, y, wheel, pan, stampUs != HID_TX_NO_STAMP ? stampUs : us_ticker_read());
+  //first report that had camera data behind it
+  if(bootFirstReportUs == BOOT_NOT_YET && bootFirstFrameUs != BOOT_NOT_YET){
+      bootFirstReportUs = us_ticker_read() - bootStartUs;
+  }
+  return true;
+}
+
+
+
+
+//the emit phase of the scheduler
+//only queues the update for the main loop
+void mouseStateTick(void){
+    postEvent(EVENT_MOUSE_TICK);
+}
+
+
+//updates the mouse state
+//runs from the main loop on every mouse tick (every 50 ms)
+void updateMouseState(){
+    PROFILE_SCOPE(PROF_MOUSE_STATE);
+    
+    myled2 = 1 - myled2;
+    
+    
+    //everything the frames posted since the last tick
+    MotionEvent tick;
+    clearMotion(tick);
+    MotionEvent frame;
+    while(motionTake(frame)){
+        mergeMotion(tick, frame);
+    }
+    
+    //latency is measured on the last report that carries the update
+    unsigned int stamp = tick.stampUs;
+    
+    //accelerate, then send the whole counts and keep the fraction for
+    //the next report
+    carryX += accelCurve(tick.dx);
+    carryY += accelCurve(tick.dy);
+    short x = clampShort(carryX / MOTION_ONE);
+    short y = clampShort(carryY / MOTION_ONE);
+    carryX -= x * MOTION_ONE;
+    carryY -= y * MOTION_ONE;
+    
+    //click, press and release for each tap that fits this tick
+    tapsToSend += tick.taps;
+    while(tapsToSend > 0 && buttonQueueLength + 2 <= BUTTON_QUEUE_SIZE){
+        queueButtons(mouseButtons | 0x01);
+        queueButtons(mouseButtons & ~0x01);
+        tapsToSend--;
+    }
+    //TODO: right click
+    //else if (toRightClick){
+    //    queueButtons(mouseButtons | 0x02); ...
+    //}
+    
+    //move mouse
+    //handles only single finger actions
+    //whatever did not fit into this tick's reports goes out next tick
+    short wheel = clampShort(carryWheel + tick.wheel);
+    short pan = clampShort(carryPan + tick.pan);
+    sendMouseReports(x, y, wheel, pan, stamp);
+    carryX += x * MOTION_ONE;
+    carryY += y * MOTION_ONE;
+    carryWheel = wheel;
+    carryPan = pan;
+    
+}
+
+
+//queues a button state to be reported on the next tick
+//states equal to the one before them are dropped when sending
+void queueButtons(char buttons){
+    if(buttonQueueLength < BUTTON_QUEUE_SIZE){
+        buttonQueue[buttonQueueLength++] = buttons;
+    }
+}
+
+
+//sends the tick's motion and queued button states in as few reports
+//as possible: the motion rides along with the first button edge, each
+//further edge gets its own report, and with no motion and no edge
+//nothing is sent at all
+//motion past the +-127 a report can hold is split over several
+//reports, at most MAX_REPORTS_PER_TICK of them unless button edges
+//need more. x/y/wheel/pan are left holding what was not sent
+//stampUs goes on the last report
+//a report the TX queue refuses ends the tick, the button edges from
+//it on stay queued for the next tick
+//returns the number of reports sent
+int sendMouseReports(short &x, short &y, short &wheel, short &pan, unsigned int stampUs){
+    int sent = 0;
+    int next = 0;
+    
+    while(true){
+        //next queued state that actually changes something
+        while(next < buttonQueueLength && buttonQueue[next] == mouseButtons){
+            next++;
+        }
+        bool edge = next < buttonQueueLength;
+        bool motion = x != 0 || y != 0 || wheel != 0 || pan != 0;
+        if(!edge && (!motion || sent >= MAX_REPORTS_PER_TICK)){
+            break;
+        }
+        
+        char buttons = edge ? buttonQueue[next] : mouseButtons;
+        int after = edge ? next + 1 : next;
+        
+        //as much of the motion as fits in one report
+        short sx = saturateReport(x);
+        short sy = saturateReport(y);
+        short sw = saturateReport(wheel);
+        short sp = saturateReport(pan);
+        
+        //last report if no edge and no motion (that still fits in this
+        //tick) is left after this one
+        bool last = x == sx && y == sy && wheel == sw && pan == sp;
+        if(sent + 1 >= MAX_REPORTS_PER_TICK){
+            last = true;
+        }
+        for(int i = after; i < buttonQueueLength; i++){
+            if(buttonQueue[i] != buttons){
+                last = false;
+            }
+        }
+        
+        //a refused report takes nothing away, the caller carries it
+        if(!mouseCommand(buttons, sx, sy, sw, sp, last ? stampUs : HID_TX_NO_STAMP)){
+            break;
+        }
+        x -= sx;
+        y -= sy;
+        wheel -= sw;
+        pan -= sp;
+        mouseButtons = buttons;
+        next = after;
+        sent++;
+    }
+    
+    //edges that did not go out, oldest first
+    int left = 0;
+    for(int i = next; i < buttonQueueLength; i++){
+        buttonQueue[left++] = buttonQueue[i];
+    }
+    buttonQueueLength = left;
+    return sent;
+}
+
+
+//moves mouse on screen from one finger input
+//param
+// current frame (curr)
+// previous frame (prev)
+// which point of the frames to look at (finger)
+void oneFingerResponse(const TrackedFrame &curr, const TrackedFrame &prev, int finger){
+    PROFILE_SCOPE(PROF_ONE_FINGER);
+    //look at delta btwn prev val and current
+    //only if the track carried on, prev then holds the same contact
+    //(the frame a track starts on already counts as prev)
+    if(trackValid(curr, finger)){
+        //in MOTION_ONE units, fractions included
+        int diffX = curr.x[finger] - prev.x[finger];
+        int diffY = -1*(curr.y[finger] - prev.y[finger]);
+        
+        
+        //mouseCommand(0, (char) diffX, (char) diffY);
+        //update target position to move x and y
+        //accumulates the diff until 
+        //updatex[finger] = updatex[finger] + diffX;
+//        updatey[finger] = updatey[finger] + diffY;
+        updatex[finger] += diffX;
+        updatey[finger] += diffY;
+       
+//        pc.printf("updating x to : %d", diffX);
+//        pc.printf("\t updating y to : %d \n", diffY);  
+        
+//        pc.printf("updating x to : %d", updatex[0]);
+//        pc.printf("\t updating y to : %d \n", updatex[0]);
+        
+    } 
+}
+
+
+//called from the camera_init Timeout once the setup has settled
+void cameraReady(void){
+    if(bootCameraReadyUs == BOOT_NOT_YET){
+        bootCameraReadyUs = us_ticker_read() - bootStartUs;
+    }
+    errorsAtLastFrame = cameraBusErrors;
+}
+
+
+// Initialize WiiMote Camera
+//the writes go out in the background (camera_init.cpp), this returns
+//right away. setup and the capture ticker only, the main loop asks
+//with restartCamera() once the scheduler runs
+void initCamera(void){
+    const CameraInitStep steps[] = {
+        {0x30, 0x01},
+        {0x00, 0x02},
+        {0x00, 0x00},
+        {0x71, 0x01},
+        {0x07, 0x00},
+        {(char)sen1, 0x1A},
+        {(char)sen2, (char)sen3},
+        {0x33, 0x03},
+        {0x30, 0x08},
+    };
+    cameraInitStart(steps, sizeof(steps) / sizeof(steps[0]), &cameraReady);
+}
+
+
+//sets the camera up again from the next capture tick (pc shell)
+void restartCamera(void){
+    cameraRestartPending = true;
+}
+
+
+//prints how long the camera, the first frame and the first report
+//took from the start of setup
+void printBootTimes(void){
+    const char *names[3] = {"camera", "first frame", "first report"};
+    unsigned int times[3] = {bootCameraReadyUs, bootFirstFrameUs, bootFirstReportUs};
+    
+    pc.printf("boot us:");
+    for(int i = 0; i < 3; i++){
+        if(times[i] == BOOT_NOT_YET){
+            pc.printf(" %s=-", names[i]);
+        } else {
+            pc.printf(" %s=%u", names[i], times[i]);
+        }
+    }
+    pc.printf(" (camera inits=%u retries=%u)\n", cameraInitRuns, cameraInitRetries);
+}
+
+
+//update counts for click 
+//runs the frame through the gesture state machine (gesture.cpp)
+void updateClickState(const IRFrame &curr, const IRFrame &prev, int finger){
+    PROFILE_SCOPE(PROF_CLICK_STATE);
+    
+    if(updateGesture(curr, finger) & GESTURE_OUT_TAP){
+        //set state to indicate left click
+        toLeftClick = true;
+        
+        //toss out accumulations of diffs
+        updatex[0] = 0;
+        updatey[0] = 0;
+    }
+}
+
+
+//the interrupt to read from the camera
+//only starts the I2C transfer, the frame shows up in the background
+//and is picked up by readCameraData() from the main loop
+//also notices a camera that stopped answering and sets it up again
+//without stopping anything else
+void requestCameraData(void){
+    if(cameraRestartPending){
+        cameraRestartPending = false;
+        initCamera();
+        return;
+    }
+    if(!cameraInitDone()){
+        return;
+    }
+    if(cameraBusErrors - errorsAtLastFrame >= CAMERA_REINIT_ERRORS){
+        initCamera();
+        return;
+    }
+    cameraStartRead();
+}
+
+
+//called from the I2C interrupt once a frame is complete
+//the scheduler queues the emit phase after it on report frames, so
+//the frame is processed before the report goes out
+void cameraFrameDone(void){
+    postEvent(EVENT_CAMERA_FRAME);
+    schedulerFrameDone();
+}
+
+
+#ifdef GHOST_PROFILE
+//the interrupt for the profile dump ticker
+void profileDumpTick(void){
+    postEvent(EVENT_PROFILE_DUMP);
+}
+
+//prints the stage timings, runs from the main loop
+void dumpProfile(void){
+    //pc belongs to the telemetry stream
+    if(telemetrySending()){
+        return;
+    }
+    profileDump(pc);
+}
+#endif
+
+
+//get data from camera one 
+//populates irFrame with values depending on the measured points
+void readCameraData(void){
+    PROFILE_SCOPE(PROF_READ_CAMERA);
+    //get the newest completed frame from the camera
+    if(!cameraTakeFrame(data_buf, &frameStampUs)){
+        return;
+    }
+    errorsAtLastFrame = cameraBusErrors;
+    if(bootFirstFrameUs == BOOT_NOT_YET){
+        bootFirstFrameUs = frameStampUs - bootStartUs;
+    }
+    
+    //raw frame as read, for replay on the host
+    recorderFrame(data_buf, frameStampUs);
+    
+    //update previous values
+    prevIRFrame = irFrame;
+        
+    //all four points in one pass, then sorted into stable contacts so
+    //a slot swap in the camera is not taken for motion
+    decodeIRFrame(data_buf, rawFrame);
+    matchContacts(rawFrame, irFrame);
+    
+    //filtered and predicted to when the report goes out
+    prevTrackedFrame = trackedFrame;
+    trackFrame(irFrame, trackedFrame);
+    
+    //speed adaptive smoothing, takes the jitter out of a resting finger
+    smoothFrame(trackedFrame);
+    
+    telemetryRaw(rawFrame, frameStampUs);
+    telemetryTrack(trackedFrame, frameStampUs);
+    
+    //if(tossedValuesCounter > 0){
+//        tossedValuesCounter -= 1;    
+//    }else{
+//        oneFingerResponse(irFrame, prevIRFrame, 0);        
+//    }
+    //two fingers down scroll, nothing else happens with them
+    short wheel, pan;
+    if(twoFingerResponse(irFrame, prevIRFrame, wheel, pan)){
+        updateWheel += wheel;
+        updatePan += pan;
+        
+        //second finger cancels a tap in progress
+        gestureEvent(GEV_CANCEL);
+    } else if(!scrollLatched()){
+        //handles only single finger actions
+        if(!gestureTouching()){
+            oneFingerResponse(trackedFrame, prevTrackedFrame, 0);            
+        }
+        
+        
+        updateClickState(irFrame, prevIRFrame, 0);
+    }
+    
+    //gesture transitions, a cancel included
+    if(gestureState() != lastGestureState){
+        telemetryGesture(gestureState(), lastGestureState, frameStampUs);
+        lastGestureState = gestureState();
+    }
+    
+    //hand the frame's motion to the report side, the frame stamp
+    //starts the latency clock
+    MotionEvent motion;
+    motion.dx = updatex[0];
+    motion.dy = updatey[0];
+    motion.wheel = updateWheel;
+    motion.pan = updatePan;
+    motion.taps = toLeftClick ? 1 : 0;
+    motion.stampUs = frameStampUs;
+    if(motionPending(motion)){
+        motionPost(motion);
+    } else {
+        //something held back from a full channel still has to go
+        motionFlush();
+    }
+    
+    //clear out changes
+    updatex[0] = 0;
+    updatey[0] = 0;
+    updateWheel = 0;
+    updatePan = 0;
+    
+    //fip clicking to false
+    toLeftClick = false;
+    toRightClick = false;
+    
+}
+
+//print to serial monitor the coordinates of the points stored in
+//the passed frame
+void printCamData(const IRFrame &frame){
+    for(int i = 0; i<IR_MAX_POINTS; i++){
+        short x = frame.point[i].x;
+        short y = frame.point[i].y;
+        //determine what to print
+        //x coordinate
+        pc.printf(" %d,", x);
+        
+        //y coordinate
+        pc.printf(" %d\t", y);     
+    }
+    
+    //new line and delay
+    pc.printf("\n");      
+    //wait(0.01);
+}
+
+
+
+
+//SHELL COMMANDS
+//each line on pc is a command and its arguments, help lists them.
+//the old single keys still work as one letter commands (followed by
+//enter now): l r b c d t w p
+
+static void pcLatency(int argc, char **argv){
+    if(argc > 1 && strcmp(argv[1], "reset") == 0){
+        latencyReset();
+    } else {
+        latencyDump(pc);
+    }
+}
+
+static void pcLatencyReset(int argc, char **argv){
+    latencyReset();
+}
+
+static void pcBoot(int argc, char **argv){
+    printBootTimes();
+}
+
+static void pcCamera(int argc, char **argv){
+    restartCamera();
+}
+
+static void pcDuty(int argc, char **argv){
+    idleDutyDump(pc);
+}
+
+//on, off, or toggle without an argument
+static void pcTelemetry(int argc, char **argv){
+    if(argc < 2){
+        telemetryEnabled = !telemetryEnabled;
+    } else if(strcmp(argv[1], "on") == 0){
+        telemetryEnabled = true;
+    } else if(strcmp(argv[1], "off") == 0){
+        telemetryEnabled = false;
+    } else {
+        pc.printf("usage: telemetry [on|off]\r\n");
+    }
+}
+
+//start, stop, or toggle without an argument
+static void pcRecord(int argc, char **argv){
+#ifndef GHOST_RECORD
+    pc.printf("not built with RECORD=1\r\n");
+#else
+    bool start = argc > 1 ? strcmp(argv[1], "start") == 0 : !recorderActive();
+    if(!start){
+        if(recorderActive()){
+            recorderStop();
+            pc.printf("recorded %u frames, %u dropped\r\n", recorderFrames, recorderDropped);
+        }
+    } else if(recorderActive()){
+        pc.printf("already recording\r\n");
+    } else if(idleSemihostLost){
+        pc.printf("can't record, idle sleep ended semihosting\r\n");
+    } else if(recorderStart(schedSamplePeriodUs)){
+        pc.printf("recording to %s\r\n", recorderPath);
+    } else {
+        pc.printf("can't open %s\r\n", recorderPath);
+    }
+#endif
+}
+
+//longest period rate takes, 1 s
+#define RATE_MAX_US 1000000
+
+//a period for rate, a number like set takes in 0..RATE_MAX_US
+static bool rateArgument(const char *text, int &us){
+    char *end;
+    long value = strtol(text, &end, 0);
+    if(end == text || *end || value < 0 || value > RATE_MAX_US){
+        return false;
+    }
+    us = (int)value;
+    return true;
+}
+
+//frame (capture) and report periods, the emit offset after the frame
+//the tracker and filters are told the new frame period, tap durations
+//stay in frames
+static void pcRate(int argc, char **argv){
+    if(argc < 3){
+        pc.printf("rate: sample %d us, report every %d frames, offset %d us\r\n",
+                  schedSamplePeriodUs, schedReportDecimation, schedEmitOffsetUs);
+        return;
+    }
+    int sampleUs, reportUs;
+    int offsetUs = SCHED_EMIT_OFFSET_US;
+    if(!rateArgument(argv[1], sampleUs) || !rateArgument(argv[2], reportUs)
+       || (argc > 3 && !rateArgument(argv[3], offsetUs))
+       || sampleUs < SCHED_MIN_SAMPLE_PERIOD_US || reportUs < sampleUs
+       || offsetUs >= sampleUs){
+        pc.printf("usage: rate <sample_us >= %d> <report_us >= sample> [offset_us < sample]\r\n",
+                  SCHED_MIN_SAMPLE_PERIOD_US);
+        return;
+    }
+    //the recording header holds the sample period of the session
+    if(recorderActive()){
+        pc.printf("stop recording first\r\n");
+        return;
+    }
+    schedulerStart(sampleUs, reportUs, offsetUs, &requestCameraData, &mouseStateTick);
+    trackFramePeriodUs = schedSamplePeriodUs;
+    euroSetPeriod(trackFramePeriodUs);
+    pcRate(1, argv);
+}
+
+//every counter the firmware keeps, in one go
+static void pcStats(int argc, char **argv){
+    pc.printf("events: overflows=%u high water=%u\r\n", eventOverflows, eventHighWater);
+    pc.printf("camera: dropped=%u skipped=%u bus errors=%u inits=%u retries=%u\r\n",
+              cameraFramesDropped, cameraReadsSkipped, cameraBusErrors,
+              cameraInitRuns, cameraInitRetries);
+    pc.printf("motion channel: stalls=%u high water=%u\r\n",
+              motionChannelStalls, motionChannelHighWater);
+    pc.printf("hid tx: bytes=%u overflows=%u high water=%u\r\n",
+              hidTxBytesSent, hidTxOverflows, hidTxHighWater);
+    pc.printf("telemetry: %s records=%u drops=%u\r\n", telemetryEnabled ? "on" : "off",
+              telemetryRecords, telemetryDrops);
+    pc.printf("recorder: %s frames=%u dropped=%u\r\n", recorderActive() ? "on" : "off",
+              recorderFrames, recorderDropped);
+    pc.printf("shell: lines dropped=%u muted=%u\r\n", shellLinesDropped, pcLinesMuted);
+    pc.printf("duty: %u/1000\r\n", idleDutyPermille());
+}
+
+#ifdef GHOST_PROFILE
+static void pcProfile(int argc, char **argv){
+    profileDump(pc);
+}
+#endif
+
+static const ShellCommand pcCommands[] = {
+    {"stats",     pcStats,        "print all counters"},
+    {"rate",      pcRate,         "[<sample_us> <report_us> [offset_us]]  frame/report periods"},
+    {"latency",   pcLatency,      "[reset]  latency distribution"},
+    {"boot",      pcBoot,         "boot timings"},
+    {"duty",      pcDuty,         "duty cycle since the last duty"},
+    {"camera",    pcCamera,       "set the camera up again"},
+    {"telemetry", pcTelemetry,    "[on|off]  binary telemetry (host/telemetry_decode.cpp)"},
+    {"record",    pcRecord,       "[start|stop]  raw frames to recorderPath"},
+#ifdef GHOST_PROFILE
+    {"profile",   pcProfile,      "stage profile"},
+    {"p",         pcProfile,      NULL},
+#endif
+    {"l",         pcLatency,      NULL},
+    {"r",         pcLatencyReset, NULL},
+    {"b",         pcBoot,         NULL},
+    {"c",         pcCamera,       NULL},
+    {"d",         pcDuty,         NULL},
+    {"t",         pcTelemetry,    NULL},
+    {"w",         pcRecord,       NULL},
+};
+
+//camera sensitivity only takes effect once the camera is set up again
+static void cameraSensitivityChanged(void){
+    restartCamera();
+}
+
+//tunables for get/set, named after the variables
+//a tap has to last more than tapMinFrames and less than tapMaxFrames,
+//min >= max would turn taps off for good
+static const char *tapMinCheck(int value){
+    return value < tapMaxFrames ? NULL : "tapMinFrames has to stay below tapMaxFrames";
+}
+
+static const char *tapMaxCheck(int value){
+    return value > tapMinFrames ? NULL : "tapMaxFrames has to stay above tapMinFrames";
+}
+
+static const ShellParam pcParams[] = {
+    {"mouseAccelCurveIndex", &mouseAccelCurveIndex, 0, ACCEL_CURVE_COUNT - 1, accelCurveChanged,
+     "accelCurves[] entry (accel_table.h)"},
+    {"trackProcessNoise",    &trackProcessNoise,    1, 64 * TRACK_ONE, NULL, "counts^2 in Q8"},
+    {"trackMeasureNoise",    &trackMeasureNoise,    1, 64 * TRACK_ONE, NULL, "counts^2 in Q8"},
+    {"trackGate",            &trackGate,            1, 1023, NULL, "counts before a jump restarts the track"},
+    {"predictHorizonUs",     &predictHorizonUs,     0, 100000, NULL, "us predicted ahead"},
+    {"euroMinCutoffQ8",      &euroMinCutoffQ8,      1, 50 << 8, NULL, "Hz in Q8 at rest"},
+    {"euroBetaQ16",          &euroBetaQ16,          0, 1 << 16, NULL, "Hz per count/s in Q16"},
+    {"euroDCutoffQ8",        &euroDCutoffQ8,        1, 50 << 8, NULL, "Hz in Q8, speed estimate"},
+    {"tapDeadZone",          &tapDeadZone,          1, 1023, NULL, "counts a tap may wander"},
+    {"tapMinFrames",         &tapMinFrames,         0, 1000, NULL, "frames a tap lasts, more than",
+     tapMinCheck},
+    {"tapMaxFrames",         &tapMaxFrames,         1, 1000, NULL, "frames a tap lasts, less than",
+     tapMaxCheck},
+    {"sen1",                 &sen1,                 0, 0xFF, cameraSensitivityChanged, "camera sensitivity"},
+    {"sen2",                 &sen2,                 0, 0xFF, cameraSensitivityChanged, "camera sensitivity"},
+    {"sen3",                 &sen3,                 0, 0xFF, cameraSensitivityChanged, "camera sensitivity"},
+};
+
+
+//sets up the camera, serial ports and tickers
+//everything main() does before its loop
+void ghostMouseSetup(void){
+    bootStartUs = us_ticker_read();
+    
+    //i2c increase
+    camera1.frequency(400000);
+    
+    //set values initially to zero
+    for(int i = 0; i < 4; i++){
+        updatex[i] = 0;
+        updatey[i] = 0;
+    }
+    
+    //no points seen yet
+    clearIRFrame(rawFrame);
+    clearIRFrame(irFrame);
+    clearIRFrame(prevIRFrame);
+    clearTrackedFrame(trackedFrame);
+    clearTrackedFrame(prevTrackedFrame);
+    carryX = 0;
+    carryY = 0;
+    carryWheel = 0;
+    carryPan = 0;
+    tapsToSend = 0;
+    resetMotionChannel();
+    resetContacts();
+    trackFramePeriodUs = SCHED_SAMPLE_PERIOD_US;
+    resetTracking();
+    euroSetPeriod(trackFramePeriodUs);
+    resetSmoothing();
+    
+    resetEvents();
+    resetScroll();
+    resetGesture();
+    mouseButtons = 0;
+    buttonQueueLength = 0;
+    
+    myled = 0;
+    myled2 = 0;
+    
+    //slaveAddress = IRsensorAddress >> 1;
+    slaveAddress = IRsensorAddress;
+    
+    //everything on the camera bus goes through the I2C interrupt,
+    //the setup writes run in the background while the rest comes up
+    cameraI2CInit(slaveAddress, &cameraFrameDone);
+    cameraRestartPending = false;
+    initCamera();
+    
+    //update baud rate
+    pc.baud(115200);
+    shellInit(&pc, pcCommands, sizeof(pcCommands) / sizeof(pcCommands[0]),
+              pcParams, sizeof(pcParams) / sizeof(pcParams[0]));
+    pc.attach(&pcRx, SerialBase::RxIrq);
+    
+    //binary telemetry shares pc, off until asked for
+    telemetryInit(&pc);
+    
+    //reports to the RN-42 go out through the TX interrupt
+    hidTxInit(&keyOut);
+    
+    //one frame clock for capture, process and emit
+    //(reads only start once the camera setup is through)
+    schedulerStart(SCHED_SAMPLE_PERIOD_US, SCHED_REPORT_PERIOD_US, SCHED_EMIT_OFFSET_US,
+                   &requestCameraData, &mouseStateTick);
+    
+#ifdef GHOST_PROFILE
+    profileInit();
+    profileDumpTicker.attach(&profileDumpTick, PROFILE_DUMP_PERIOD);
+#endif
+    
+    //duty cycle is measured from here on
+    idleDutyReset();
+}
+
+
+//the interrupt for pc RX, collects the line for the main loop
+void pcRx(void){
+    while(pc.readable()){
+        if(shellRx(pc.getc())){
+            postEvent(EVENT_PC_COMMAND);
+        }
+    }
+}
+
+
+//lines that turn telemetry off, the only ones taken while it is on
+//matched on words like the shell runs them, spaces don't matter
+static bool turnsTelemetryOff(const char *line){
+    char words[SHELL_LINE_MAX];
+    strcpy(words, line);
+    char *argv[SHELL_MAX_ARGS];
+    int argc = shellSplitWords(words, argv);
+    if(argc < 1 || argc > 2){
+        return false;
+    }
+    if(strcmp(argv[0], "t") != 0 && strcmp(argv[0], "telemetry") != 0){
+        return false;
+    }
+    return argc == 1 || strcmp(argv[1], "off") == 0;
+}
+
+
+//runs the line the shell has waiting
+//shell output would land inside the telemetry records, so while they
+//are going out the line is ignored unless it turns telemetry off
+void runPcCommand(void){
+    char line[SHELL_LINE_MAX];
+    if(!shellTakeLine(line)){
+        return;
+    }
+    if(telemetrySending() && !turnsTelemetryOff(line)){
+        pcLinesMuted++;
+        return;
+    }
+    shellExecute(line);
+}
+
+
+//what the main loop runs for each event
+static void (*const eventHandlers[EVENT_COUNT])(void) = {
+    readCameraData,     //EVENT_CAMERA_FRAME
+    updateMouseState,   //EVENT_MOUSE_TICK
+    runPcCommand,       //EVENT_PC_COMMAND
+#ifdef GHOST_PROFILE
+    dumpProfile,        //EVENT_PROFILE_DUMP
+#endif
+};
+
+
+//one pass of the main loop
+void ghostMouseLoop(void){
+
+    //pc.printf("while\n");
+    
+    //toggle test LED, once per wake up now
+    myled = 1 - myled;
+    
+    //pc.printf("while2\n");
+    
+    //run everything the interrupts have queued up, one at a time
+    GhostEvent event;
+    while(takeEvent(event)){
+        eventHandlers[event]();
+    }
+    
+    //recording goes to the file in the time left over
+    recorderFlush();
+    
+    //nothing left to do until the next interrupt
+    idleSleep();
+    
+    //printing clicking state -- FOR DEBUGGING
+//    pc.printf("readyForClick %s", readyForClick ? "true" : "false");
+//    pc.printf("\treadingClick %s", readingClick ? "true" : "false");        
+//    pc.printf("\treadyForClickRelease %s\n", readyForClickRelease ? "true" : "false");        
+    
+    
+    
+    
+    //printing mouse state -- FOR DEBUGGING
+//    pc.printf("update mouse %d, %d", updatex[0], updatey[0]);
+//    pc.printf("\tclick left %s", toLeftClick ? "true" : "false");
+//    pc.printf("\tclick right %s\n", toRightClick ? "true" : "false");
+    
+    //print points
+    //printCamData(irFrame);  
+    
+    
+    
+    
+    
+    
+    //uncomment below to test infinite print
+//    keyOut.putc(0x41);
+    
+    //uncomment below to infinitely move mouse in a square
+//    double delay = 0.1;
+//    int change = 75;
+//    mouseCommand(0,0, (char) -1*change);
+//    wait(delay);
+//    mouseCommand(0,(char) -1*change,0);
+//    wait(delay);  
+//    mouseCommand(0,0, (char) change);
+//    wait(delay);
+//    mouseCommand(0,(char) change,0);
+//    wait(delay);
+}
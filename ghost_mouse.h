@@ -0,0 +1,67 @@
+#ifndef GHOST_MOUSE_H
+#define GHOST_MOUSE_H
+
+#include "mbed.h"
+#include "ir_frame.h"
+#include "hid_tx.h"
+#include "kalman.h"
+
+//******************************************************************
+// Gesture pipeline shared by the firmware and the host build
+//******************************************************************
+
+//communication
+extern RawSerial pc;
+extern RawSerial keyOut;
+
+//setup and one pass of the main loop, main() is just these two
+void ghostMouseSetup(void);
+void ghostMouseLoop(void);
+
+//interrupt side, these only start transfers or post events
+//(requestCameraData and mouseStateTick are the capture and emit
+//phases of scheduler.h)
+void mouseStateTick(void);
+void requestCameraData(void);
+void cameraFrameDone(void);
+void pcRx(void);
+
+//pipeline stages, run from the main loop
+bool mouseCommand(char buttons, short x, short y, short wheel = 0, short pan = 0, unsigned int stampUs = HID_TX_NO_STAMP);
+void updateMouseState(void);
+void queueButtons(char buttons);
+int sendMouseReports(short &x, short &y, short &wheel, short &pan, unsigned int stampUs = HID_TX_NO_STAMP);
+
+//range of the signed byte motion/scroll fields of a report
+#define REPORT_MAX 127
+
+//clamps a delta to what one report field can hold
+inline short saturateReport(int d){
+    if(d > REPORT_MAX){
+        return REPORT_MAX;
+    } else if(d < -REPORT_MAX){
+        return -REPORT_MAX;
+    }
+    return d;
+}
+
+inline short clampShort(int d){
+    if(d > 32767){
+        return 32767;
+    } else if(d < -32767){
+        return -32767;
+    }
+    return d;
+}
+void oneFingerResponse(const TrackedFrame &curr, const TrackedFrame &prev, int finger);
+void updateClickState(const IRFrame &curr, const IRFrame &prev, int finger);
+void readCameraData(void);
+void runPcCommand(void);
+
+//camera setup (non-blocking) and the boot timings
+void initCamera(void);
+void restartCamera(void);
+void cameraReady(void);
+void printBootTimes(void);
+
+#endif
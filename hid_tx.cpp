@@ -0,0 +1,122 @@
+#include "hid_tx.h"
+#include "lockfree_buffer.h"
+#include "latency.h"
+
+//frame stamp of a queued write and the byte count at which its last
+//byte has gone out
+struct TxStamp {
+    unsigned int endCount;
+    unsigned int stampUs;
+};
+
+static RawSerial *txPort = NULL;
+
+//time a byte takes on the wire (start, 8 data, stop bits)
+static unsigned int byteUs = 0;
+
+static LockFreeCircularBuffer<char, HID_TX_BUFFER_SIZE> txBuffer;
+static LockFreeCircularBuffer<TxStamp, 16> txStamps;
+
+//bytes ever queued, only touched by the writer
+static unsigned int bytesQueued = 0;
+
+//true while the TX interrupt is attached and draining the buffer
+static volatile bool txActive = false;
+
+volatile unsigned int hidTxHighWater = 0;
+volatile unsigned int hidTxOverflows = 0;
+volatile unsigned int hidTxBytesSent = 0;
+
+
+//TX interrupt, moves bytes from the buffer into the UART
+//detaches itself once the buffer runs dry
+static void hidTxIrq(void){
+    char c;
+    while(txPort->writeable()){
+        if(!txBuffer.pop(c)){
+            txPort->attach(NULL, SerialBase::TxIrq);
+            txActive = false;
+            return;
+        }
+        txPort->putc(c);
+        hidTxBytesSent++;
+
+        //last byte of a stamped write is in the UART. writeable() means
+        //the FIFO was empty, so it is on the wire one byte time from now
+        //(plus the rest of the byte still shifting out, if any)
+        TxStamp stamp;
+        if(txStamps.peek(stamp) && stamp.endCount == hidTxBytesSent){
+            latencyRecord(us_ticker_read() + byteUs - stamp.stampUs);
+            txStamps.pop(stamp);
+        }
+    }
+}
+
+
+//starts the TX interrupt if it is not running yet
+static void kickTx(void){
+    bool start = false;
+
+    core_util_critical_section_enter();
+    if(!txActive){
+        txActive = true;
+        start = true;
+    }
+    core_util_critical_section_exit();
+
+    if(start){
+        //push the first byte by hand, the interrupt only fires on the
+        //transition to empty
+        hidTxIrq();
+        if(txActive){
+            txPort->attach(&hidTxIrq, SerialBase::TxIrq);
+        }
+    }
+}
+
+
+void hidTxInit(RawSerial *port, int baud){
+    txPort = port;
+    txPort->baud(baud);
+    byteUs = (10 * 1000000 + baud - 1) / baud;
+    txBuffer.reset();
+    txStamps.reset();
+    txActive = false;
+    bytesQueued = 0;
+    hidTxBytesSent = 0;
+}
+
+
+bool hidTxWrite(const char *data, int len, unsigned int stampUs){
+    if((int)txBuffer.space() < len){
+        hidTxOverflows++;
+        return false;
+    }
+
+    //stamp goes in first so it is there by the time the last byte is sent
+    //(if the stamp queue is full the sample is just skipped)
+    bytesQueued += len;
+    if(stampUs != HID_TX_NO_STAMP){
+        TxStamp stamp;
+        stamp.endCount = bytesQueued;
+        stamp.stampUs = stampUs;
+        txStamps.push(stamp);
+    }
+
+    for(int i = 0; i < len; i++){
+        txBuffer.push(data[i]);
+    }
+
+    unsigned int depth = txBuffer.size();
+    if(depth > hidTxHighWater){
+        hidTxHighWater = depth;
+    }
+
+    kickTx();
+    return true;
+}
+
+
+int hidTxDepth(void){
+    return txBuffer.size();
+}
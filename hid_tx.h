@@ -0,0 +1,42 @@
+#ifndef HID_TX_H
+#define HID_TX_H
+
+#include "mbed.h"
+#include "stamp.h"
+
+//******************************************************************
+// Interrupt driven transmit queue for the RN-42 link (keyOut)
+//******************************************************************
+//
+// reports are copied into a ring buffer and the UART TX interrupt
+// feeds them out one byte at a time, so sending a report never
+// waits on the serial port.
+
+//bytes of queued output, has to be a power of two
+#define HID_TX_BUFFER_SIZE 128
+
+//link rate to the RN-42, the mbed default keyOut has always run at
+#define HID_TX_BAUD 9600
+
+//sets the port to baud and hooks its TX interrupt
+void hidTxInit(RawSerial *port, int baud = HID_TX_BAUD);
+
+//no latency sample for this write
+#define HID_TX_NO_STAMP NO_STAMP
+
+//queues len bytes for sending, all or nothing
+//returns false (and counts an overflow) if there is not enough room
+//if stampUs is given (us_ticker_read() time of the frame behind the
+//data), the time from it until the last byte has left the UART goes
+//into latency.h
+bool hidTxWrite(const char *data, int len, unsigned int stampUs = HID_TX_NO_STAMP);
+
+//bytes currently waiting in the queue
+int hidTxDepth(void);
+
+//backpressure counters
+extern volatile unsigned int hidTxHighWater;   //deepest the queue has been
+extern volatile unsigned int hidTxOverflows;   //writes refused because the queue was full
+extern volatile unsigned int hidTxBytesSent;
+
+#endif
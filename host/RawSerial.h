@@ -0,0 +1,7 @@
+#ifndef HOST_RAWSERIAL_H
+#define HOST_RAWSERIAL_H
+
+//main code includes <RawSerial.h> directly, the stand-in lives in mbed.h
+#include "mbed.h"
+
+#endif
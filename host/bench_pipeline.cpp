@@ -0,0 +1,151 @@
+#include "mbed.h"
+#include "ghost_mouse.h"
+#include "profiler.h"
+#include "sim_camera.h"
+#include "sim_run.h"
+#include "synth_trace.h"
+
+#include <unistd.h>
+#include <sys/wait.h>
+#include <time.h>
+
+//******************************************************************
+// Pipeline throughput on synthetic traces
+//******************************************************************
+//
+// usage: bench_pipeline [frames [motion]]
+//
+// runs frames (default 1000000) synthetic camera frames of each motion
+// of synth_trace.h, or just the one named, through the pipeline the
+// way ghost_mouse_host does, and prints per motion
+//  - wall time per frame and frames per second of the whole run, the
+//    virtual clock and the stand-ins included
+//  - per profiler stage: calls, mean and max ns per call, ns per frame
+//    and the heap allocations made inside the stage
+//
+// needs the profiled build (make -f Makefile.host bench). stage times
+// come from rdtsc, turned into ns with the rate measured over the run.
+// allocations are counted by the malloc below, the capture buffers of
+// the serial stand-ins are reserved up front so they do not show up.
+
+#ifndef GHOST_PROFILE
+#error "bench_pipeline needs the profiled build, make -f Makefile.host bench"
+#endif
+
+#define BENCH_DEFAULT_FRAMES 1000000
+
+//counts every allocation for the profiler, operator new ends up here too
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t n, size_t size);
+extern "C" void *__libc_realloc(void *p, size_t size);
+
+extern "C" void *malloc(size_t size) {
+    profileAllocs++;
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t n, size_t size) {
+    profileAllocs++;
+    return __libc_calloc(n, size);
+}
+
+extern "C" void *realloc(void *p, size_t size) {
+    profileAllocs++;
+    return __libc_realloc(p, size);
+}
+
+//periodic profile print of the firmware, not wanted here
+extern Ticker profileDumpTicker;
+
+
+static unsigned long long wallNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+
+//one motion, run in a process of its own so the pipeline starts fresh
+static void benchMotion(SynthMotion motion, int frames) {
+    SynthParams params;
+    synthDefaults(motion, params);
+    synthStart(params);
+    for (int f = 0; f < frames; f++) {
+        char data[CAMERA_FRAME_SIZE];
+        synthFrame(data);
+        simCameraPush(data);
+    }
+
+    ghostMouseSetup();
+    profileDumpTicker.detach();
+
+    //a report per frame at the most, clicks take two
+    keyOut.simTx.reserve(frames * 2 * 9 + 1024);
+    keyOut.simTxDoneUs.reserve(frames * 2 * 9 + 1024);
+    pc.simTx.reserve(64 * 1024);
+    pc.simTxDoneUs.reserve(64 * 1024);
+
+    profileInit();
+    unsigned int allocsBefore = profileAllocs;
+    unsigned long long wallStart = wallNow();
+    unsigned long long tscStart = __rdtsc();
+
+    simRunPipeline();
+
+    unsigned long long tscEnd = __rdtsc();
+    unsigned long long wallNs = wallNow() - wallStart;
+    unsigned int allocs = profileAllocs - allocsBefore;
+
+    double nsPerCycle = tscEnd > tscStart ? (double)wallNs / (tscEnd - tscStart) : 0;
+
+    printf("%s: speed %d, noise %d, dropout %d/1000\n", synthMotionName(motion),
+           params.speed, params.noise, params.dropoutPermille);
+    printf("  %d frames in %.3f s, %.0f ns/frame, %.0f frames/s, %u reports, %u allocations\n",
+           frames, wallNs / 1e9, (double)wallNs / frames, frames * 1e9 / wallNs,
+           (unsigned int)(keyOut.simTx.size() / 9), allocs);
+    printf("  %-18s %9s %9s %9s %9s %7s\n", "stage", "calls", "ns/call", "max ns", "ns/frame", "allocs");
+    for (int i = 0; i < PROF_STAGE_COUNT; i++) {
+        const ProfileStats &s = profileStats[i];
+        double mean = s.count ? (double)s.total / s.count * nsPerCycle : 0;
+        printf("  %-18s %9u %9.0f %9.0f %9.1f %7u\n", profileStageName((ProfileStage)i),
+               s.count, mean, s.max * nsPerCycle, s.total * nsPerCycle / frames, s.allocs);
+    }
+    fflush(stdout);
+}
+
+
+int main(int argc, char **argv) {
+    int frames = argc > 1 ? atoi(argv[1]) : BENCH_DEFAULT_FRAMES;
+    int first = 0, last = SYNTH_MOTION_COUNT - 1;
+    if (argc > 2) {
+        SynthMotion motion;
+        if (!synthMotionByName(argv[2], motion)) {
+            fprintf(stderr, "unknown motion %s\n", argv[2]);
+            return 2;
+        }
+        first = last = motion;
+    }
+    if (frames <= 0) {
+        fprintf(stderr, "usage: %s [frames [motion]]\n", argv[0]);
+        return 2;
+    }
+
+    for (int m = first; m <= last; m++) {
+        fflush(stdout);
+        pid_t pid = fork();
+        if (pid < 0) {
+            return 1;
+        }
+        if (pid == 0) {
+            benchMotion((SynthMotion)m, frames);
+            _exit(0);
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            fprintf(stderr, "%s: run failed\n", synthMotionName((SynthMotion)m));
+            return 1;
+        }
+    }
+    return 0;
+}
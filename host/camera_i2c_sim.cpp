@@ -0,0 +1,282 @@
+#include "mbed.h"
+#include "sim_camera.h"
+#include "recorder.h"
+
+volatile unsigned int cameraFramesDropped = 0;
+volatile unsigned int cameraReadsSkipped = 0;
+volatile unsigned int cameraBusErrors = 0;
+
+int simCameraWrites = 0;
+
+int simRecordingSessions = 0;
+int simRecordingGaps = 0;
+int simRecordingPeriodUs = 0;
+
+static std::vector<char> script;
+static size_t scriptPos = 0;
+
+static char readyFrame[CAMERA_FRAME_SIZE];
+static unsigned int readyStampUs = 0;
+static bool frameReady = false;
+static void (*frameCallback)(void) = NULL;
+
+
+//completes the read that cameraStartRead() kicked off
+class SimCameraBus : public SimTimed {
+public:
+    SimCameraBus() : busy(false), writing(false), doneUs(0) {}
+
+    virtual bool simPending(uint64_t &at) {
+        if (!busy) {
+            return false;
+        }
+        at = doneUs;
+        return true;
+    }
+
+    virtual void simFire(void) {
+        busy = false;
+        if (writing) {
+            //setup write, nothing comes back
+            writing = false;
+            return;
+        }
+        if (frameReady) {
+            cameraFramesDropped++;
+        }
+        if (scriptPos + CAMERA_FRAME_SIZE <= script.size()) {
+            memcpy(readyFrame, &script[scriptPos], CAMERA_FRAME_SIZE);
+            scriptPos += CAMERA_FRAME_SIZE;
+        } else {
+            memset(readyFrame, 0xFF, CAMERA_FRAME_SIZE);
+        }
+        readyStampUs = us_ticker_read();
+        frameReady = true;
+
+        if (frameCallback) {
+            frameCallback();
+        }
+    }
+
+    bool busy;
+    bool writing;
+    uint64_t doneUs;
+};
+
+static SimCameraBus bus;
+
+
+//******************************************************************
+// camera_i2c.h
+//******************************************************************
+
+void cameraI2CInit(int address, void (*onFrame)(void)) {
+    bus.busy = false;
+    frameCallback = onFrame;
+}
+
+bool cameraStartRead(void) {
+    if (bus.busy) {
+        cameraReadsSkipped++;
+        return false;
+    }
+    bus.busy = true;
+    bus.doneUs = simNow() + SIM_CAMERA_READ_US;
+    return true;
+}
+
+bool cameraStartWrite(const char *data, int len) {
+    if (bus.busy || len < 1 || len > CAMERA_WRITE_MAX) {
+        return false;
+    }
+    bus.busy = true;
+    bus.writing = true;
+    bus.doneUs = simNow() + SIM_CAMERA_WRITE_US;
+    simCameraWrites++;
+    return true;
+}
+
+bool cameraBusIdle(void) {
+    return !bus.busy;
+}
+
+bool cameraFrameReady(void) {
+    return frameReady;
+}
+
+bool cameraTakeFrame(char dest[CAMERA_FRAME_SIZE], unsigned int *stampUs) {
+    if (!frameReady) {
+        return false;
+    }
+    memcpy(dest, readyFrame, CAMERA_FRAME_SIZE);
+    if (stampUs) {
+        *stampUs = readyStampUs;
+    }
+    frameReady = false;
+    return true;
+}
+
+
+//******************************************************************
+// Script
+//******************************************************************
+
+void simCameraEncode(char frame[CAMERA_FRAME_SIZE], const short x[4], const short y[4], const char size[4]) {
+    memset(frame, 0, CAMERA_FRAME_SIZE);
+    for (int i = 0; i < 4; i++) {
+        int base = 1 + 3 * i;
+        frame[base] = x[i] & 0xFF;
+        frame[base + 1] = y[i] & 0xFF;
+        frame[base + 2] = ((y[i] >> 2) & 0xC0) | ((x[i] >> 4) & 0x30) | (size[i] & 0x0F);
+    }
+}
+
+void simCameraPush(const char frame[CAMERA_FRAME_SIZE]) {
+    script.insert(script.end(), frame, frame + CAMERA_FRAME_SIZE);
+}
+
+void simCameraReset(void) {
+    script.clear();
+    scriptPos = 0;
+    frameReady = false;
+    bus.busy = false;
+    bus.writing = false;
+    simCameraWrites = 0;
+    cameraFramesDropped = 0;
+    cameraReadsSkipped = 0;
+    cameraBusErrors = 0;
+}
+
+int simCameraRemaining(void) {
+    return (script.size() - scriptPos) / CAMERA_FRAME_SIZE;
+}
+
+int simCameraLoadTrace(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return -1;
+    }
+
+    int frames = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        char *hash = strchr(line, '#');
+        if (hash) {
+            *hash = '\0';
+        }
+
+        short x[4], y[4];
+        char size[4];
+        int points = 0;
+        bool blank = true;
+        char *tok = strtok(line, " \t\r\n,");
+        while (tok && points < 4) {
+            blank = false;
+            if (strcmp(tok, "-") == 0) {
+                x[points] = SIM_NO_POINT;
+                y[points] = SIM_NO_POINT;
+            } else {
+                char *ytok = strtok(NULL, " \t\r\n,");
+                x[points] = atoi(tok);
+                y[points] = ytok ? atoi(ytok) : SIM_NO_POINT;
+            }
+            points++;
+            tok = strtok(NULL, " \t\r\n,");
+        }
+        if (blank) {
+            continue;
+        }
+        for (int i = 0; i < 4; i++) {
+            if (i >= points) {
+                x[i] = SIM_NO_POINT;
+                y[i] = SIM_NO_POINT;
+            }
+            size[i] = (x[i] == SIM_NO_POINT) ? 0x0F : 0x03;
+        }
+
+        char frame[CAMERA_FRAME_SIZE];
+        simCameraEncode(frame, x, y, size);
+        simCameraPush(frame);
+        frames++;
+    }
+
+    fclose(f);
+    return frames;
+}
+
+
+//******************************************************************
+// Recordings
+//******************************************************************
+
+static unsigned int getStamp(const unsigned char *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+//true if the record is a session header of a version we can read
+static bool sessionHeader(const unsigned char *record) {
+    return getStamp(record) == RECORDER_SESSION_MARK && memcmp(record + 4, RECORDER_MAGIC, 4) == 0
+        && record[8] == RECORDER_VERSION && record[9] == CAMERA_FRAME_SIZE;
+}
+
+bool simCameraIsRecording(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return false;
+    }
+    unsigned char record[RECORDER_RECORD_SIZE];
+    bool is = fread(record, 1, sizeof(record), f) == sizeof(record) && sessionHeader(record);
+    fclose(f);
+    return is;
+}
+
+int simCameraLoadRecording(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return -1;
+    }
+
+    simRecordingSessions = 0;
+    simRecordingGaps = 0;
+    simRecordingPeriodUs = 0;
+
+    int frames = 0;
+    bool haveStamp = false;
+    unsigned int lastStamp = 0;
+    unsigned char record[RECORDER_RECORD_SIZE];
+    while (fread(record, 1, sizeof(record), f) == sizeof(record)) {
+        if (getStamp(record) == RECORDER_SESSION_MARK) {
+            if (!sessionHeader(record)) {
+                break;
+            }
+            if (simRecordingSessions > 0) {
+                char blank[CAMERA_FRAME_SIZE];
+                memset(blank, 0xFF, CAMERA_FRAME_SIZE);
+                for (int i = 0; i < SIM_SESSION_GAP_FRAMES; i++) {
+                    simCameraPush(blank);
+                    frames++;
+                }
+            }
+            simRecordingSessions++;
+            simRecordingPeriodUs = getStamp(record + 12);
+            haveStamp = false;
+            continue;
+        }
+        if (simRecordingSessions == 0) {
+            break;
+        }
+
+        unsigned int stamp = getStamp(record);
+        if (haveStamp && stamp - lastStamp > (unsigned int)simRecordingPeriodUs * 3 / 2) {
+            simRecordingGaps++;
+        }
+        haveStamp = true;
+        lastStamp = stamp;
+
+        simCameraPush((const char *)record + 4);
+        frames++;
+    }
+
+    fclose(f);
+    return simRecordingSessions > 0 ? frames : -1;
+}
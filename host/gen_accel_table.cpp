@@ -0,0 +1,66 @@
+//******************************************************************
+// Generates accel_table.h
+//******************************************************************
+//
+// usage: gen_accel_table > accel_table.h
+//
+// each table holds mult * powf(d, pwr) for d = 0..ACCEL_TABLE_SIZE-1,
+// the expression mouseCommand() used to evaluate per report, in fixed
+// point with ACCEL_FRAC_BITS fractional bits. accelCurve() interpolates
+// between entries so fractional deltas and the fractional part of the
+// result are kept instead of being truncated away.
+
+#include <stdio.h>
+#include <math.h>
+
+#define ACCEL_TABLE_SIZE 256
+#define ACCEL_FRAC_BITS 8
+
+struct Curve {
+    const char *name;
+    float mult;
+    float pwr;
+};
+
+//add a line here and regenerate to make another curve selectable
+static const Curve curves[] = {
+    {"accelCurve_m1_p1_0", 1, 1.0},
+    {"accelCurve_m1_p1_2", 1, 1.2},
+    {"accelCurve_m1_p1_5", 1, 1.5},
+    {"accelCurve_m1_p2_0", 1, 2.0},
+    {"accelCurve_m3_p1_0", 3, 1.0},
+};
+
+int main(void) {
+    printf("// Generated by host/gen_accel_table.cpp, do not edit\n");
+    printf("// regenerate with: make -f Makefile.host accel_table\n\n");
+    printf("#ifndef ACCEL_TABLE_H\n#define ACCEL_TABLE_H\n\n");
+    printf("#define ACCEL_TABLE_SIZE %d\n", ACCEL_TABLE_SIZE);
+    printf("#define ACCEL_FRAC_BITS %d\n", ACCEL_FRAC_BITS);
+
+    for (unsigned int c = 0; c < sizeof(curves) / sizeof(curves[0]); c++) {
+        const float mouseMoveMult = curves[c].mult;
+        const float mouseMovePwr = curves[c].pwr;
+
+        printf("\n//mouseMoveMult = %g, mouseMovePwr = %g\n", mouseMoveMult, mouseMovePwr);
+        printf("static const int %s[ACCEL_TABLE_SIZE] = {", curves[c].name);
+        for (int d = 0; d < ACCEL_TABLE_SIZE; d++) {
+            float f = mouseMoveMult * ((d > 0) ? powf(((float) d), mouseMovePwr) : 0.0f);
+            int x = (int)lrintf(f * (1 << ACCEL_FRAC_BITS));
+            printf("%s%s%d", d ? "," : "", (d % 16) ? " " : "\n    ", x);
+        }
+        printf("\n};\n");
+    }
+
+    //every table by index, for picking one at runtime
+    const unsigned int count = sizeof(curves) / sizeof(curves[0]);
+    printf("\n#define ACCEL_CURVE_COUNT %u\n", count);
+    printf("\nstatic const int *const accelCurves[ACCEL_CURVE_COUNT] = {\n");
+    for (unsigned int c = 0; c < count; c++) {
+        printf("    %s%s\n", curves[c].name, c + 1 < count ? "," : "");
+    }
+    printf("};\n");
+
+    printf("\n#endif\n");
+    return 0;
+}
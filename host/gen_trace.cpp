@@ -0,0 +1,76 @@
+#include "mbed.h"
+#include "synth_trace.h"
+#include "ir_frame.h"
+
+//******************************************************************
+// Writes a synthetic trace (synth_trace.h) as a text trace
+//******************************************************************
+//
+// usage: gen_trace <motion> <frames> [speed [noise [dropout_permille [seed]]]]
+//
+// motion is one of flick, slow_drag, tap, scroll, still, four_blobs.
+// what is left out takes the motion's defaults. the output goes to
+// stdout in the format of host/traces/, ready for ghost_mouse_host or
+// the golden corpus.
+
+int main(int argc, char **argv) {
+    SynthMotion motion;
+    if (argc < 3 || !synthMotionByName(argv[1], motion)) {
+        fprintf(stderr, "usage: %s <motion> <frames> [speed [noise [dropout_permille [seed]]]]\n", argv[0]);
+        fprintf(stderr, "motions:");
+        for (int i = 0; i < SYNTH_MOTION_COUNT; i++) {
+            fprintf(stderr, " %s", synthMotionName((SynthMotion)i));
+        }
+        fprintf(stderr, "\n");
+        return 2;
+    }
+    int frames = atoi(argv[2]);
+
+    SynthParams params;
+    synthDefaults(motion, params);
+    if (argc > 3) {
+        params.speed = atoi(argv[3]);
+    }
+    if (argc > 4) {
+        params.noise = atoi(argv[4]);
+    }
+    if (argc > 5) {
+        params.dropoutPermille = atoi(argv[5]);
+    }
+    if (argc > 6) {
+        params.seed = strtoul(argv[6], NULL, 0);
+    }
+
+    printf("# %s, %d frames, speed %d, noise %d, dropout %d/1000, seed %u\n",
+           synthMotionName(motion), frames, params.speed, params.noise,
+           params.dropoutPermille, params.seed);
+
+    synthStart(params);
+    for (int f = 0; f < frames; f++) {
+        char data[CAMERA_FRAME_SIZE];
+        IRFrame frame;
+        synthFrame(data);
+        decodeIRFrame(data, frame);
+
+        //up to the last blob, "-" for the empty slots before it
+        int last = -1;
+        for (int i = 0; i < IR_MAX_POINTS; i++) {
+            if (irPointValid(frame, i)) {
+                last = i;
+            }
+        }
+        if (last < 0) {
+            printf("-\n");
+            continue;
+        }
+        for (int i = 0; i <= last; i++) {
+            if (irPointValid(frame, i)) {
+                printf("%s%d %d", i ? "  " : "", frame.point[i].x, frame.point[i].y);
+            } else {
+                printf("%s-", i ? "  " : "");
+            }
+        }
+        printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include "mbed.h"
+#include "ghost_mouse.h"
+#include "sim_camera.h"
+#include "sim_run.h"
+#include "profiler.h"
+#include "latency.h"
+#include "idle.h"
+#include "telemetry.h"
+#include "recorder.h"
+#include "scheduler.h"
+
+//******************************************************************
+// Host driver: runs a camera trace through the pipeline
+//******************************************************************
+//
+// usage: ghost_mouse_host [-r out.rec] <trace.txt|in.rec> [telemetry.bin]
+//
+// prints every RN-42 report that went out on keyOut with the virtual
+// time its last byte left the UART. the input is either a text trace
+// or a recording made on the board (recorder.h), which replays the
+// real camera frames. with a second argument telemetry is switched on
+// and the binary stream sent on pc is written to that file, for
+// host/telemetry_decode.cpp. -r records the frames the pipeline
+// processed, as the board would, and appends them to out.rec.
+
+#define REPORT_SIZE 9
+
+
+//walks the captured keyOut bytes and prints each raw mouse report
+static int printReports(void) {
+    const std::vector<unsigned char> &tx = keyOut.simTx;
+    int reports = 0;
+    for (size_t i = 0; i + REPORT_SIZE <= tx.size(); ) {
+        if (tx[i] != 0xFD) {
+            printf("# stray byte 0x%02X at %u\n", tx[i], (unsigned int)i);
+            i++;
+            continue;
+        }
+        printf("%10llu  buttons=%02X  dx=%4d  dy=%4d  wheel=%4d  pan=%4d\n",
+               (unsigned long long)keyOut.simTxDoneUs[i + REPORT_SIZE - 1],
+               tx[i + 3], (signed char)tx[i + 4], (signed char)tx[i + 5],
+               (signed char)tx[i + 6], (signed char)tx[i + 7]);
+        reports++;
+        i += REPORT_SIZE;
+    }
+    return reports;
+}
+
+
+int main(int argc, char **argv) {
+    const char *recordPath = NULL;
+    int arg = 1;
+    if (arg + 1 < argc && strcmp(argv[arg], "-r") == 0) {
+        recordPath = argv[arg + 1];
+        arg += 2;
+    }
+    if (arg >= argc) {
+        fprintf(stderr, "usage: %s [-r out.rec] <trace.txt|in.rec> [telemetry.bin]\n", argv[0]);
+        return 2;
+    }
+    const char *inputPath = argv[arg];
+    const char *telemetryPath = arg + 1 < argc ? argv[arg + 1] : NULL;
+
+    int frames = simLoadInput(inputPath);
+    if (frames < 0) {
+        fprintf(stderr, "can't open %s\n", inputPath);
+        return 1;
+    }
+    if (simRecordingSessions > 0) {
+        printf("# recording: %d sessions, %d gaps, sample period %d us\n",
+               simRecordingSessions, simRecordingGaps, simRecordingPeriodUs);
+    }
+
+    ghostMouseSetup();
+    if (telemetryPath) {
+        telemetryEnabled = true;
+    }
+    if (recordPath) {
+        recorderPath = recordPath;
+        if (!recorderStart(schedSamplePeriodUs)) {
+            fprintf(stderr, "can't write %s\n", recordPath);
+            return 1;
+        }
+    }
+
+    simRunPipeline();
+
+    if (recordPath) {
+        recorderStop();
+        printf("# recorded %u frames, %u dropped\n", recorderFrames, recorderDropped);
+    }
+
+    int reports = printReports();
+    printf("# %d frames, %d reports, %u bytes, %llu us\n",
+           frames, reports, (unsigned int)keyOut.simTx.size(), (unsigned long long)simNow());
+
+    //everything on pc so far is telemetry, the text below is not
+    size_t telemetryBytes = pc.simTx.size();
+    if (telemetryPath) {
+        FILE *out = fopen(telemetryPath, "wb");
+        if (!out) {
+            fprintf(stderr, "can't write %s\n", telemetryPath);
+            return 1;
+        }
+        if (telemetryBytes) {
+            fwrite(&pc.simTx[0], 1, telemetryBytes, out);
+        }
+        fclose(out);
+        printf("# %u telemetry records, %u dropped, %u bytes\n",
+               telemetryRecords, telemetryDrops, (unsigned int)telemetryBytes);
+    } else {
+        telemetryBytes = 0;
+    }
+
+    latencyDump(pc);
+    printBootTimes();
+    idleDutyDump(pc);
+#ifdef GHOST_PROFILE
+    profileDump(pc);
+#endif
+
+    //anything the firmware printed on pc
+    if (pc.simTx.size() > telemetryBytes) {
+        printf("# pc:\n");
+        fwrite(&pc.simTx[telemetryBytes], 1, pc.simTx.size() - telemetryBytes, stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,217 @@
+#include "mbed.h"
+#include "lpc_i2c_sim.h"
+
+//I2CONSET / I2CONCLR bits, as in camera_i2c.cpp
+#define I2C_AA   0x04
+#define I2C_SI   0x08
+#define I2C_STO  0x10
+#define I2C_STA  0x20
+#define I2C_EN   0x40
+
+//I2STAT with nothing going on
+#define STAT_IDLE 0xF8
+
+//bus steps simI2CRun() takes at the most, a driver that never lets go
+//of the bus is stopped there
+#define SIM_I2C_MAX_STEPS 1000
+
+LPC_I2C_TypeDef simI2C1;
+
+std::vector<unsigned char> simI2CWritten;
+unsigned int simI2CStops = 0;
+unsigned int simI2CInterrupts = 0;
+
+static uint32_t con = 0;
+static uint32_t stat = STAT_IDLE;
+static uint32_t dat = 0;
+static bool held = false;
+
+static void (*vector)(void) = NULL;
+static bool irqEnabled = false;
+
+static int slave = 0;
+static std::vector<unsigned char> slaveData;
+static size_t readPos = 0;
+
+static bool faultArmed = false;
+static SimI2CFault faultKind = SIM_I2C_NACK;
+static int faultCountdown = 0;
+
+
+void SimI2CConSet::operator=(uint32_t bits) {
+    con |= bits;
+}
+
+void SimI2CConClr::operator=(uint32_t bits) {
+    con &= ~bits;
+}
+
+SimI2CStat::operator uint32_t() const {
+    return stat;
+}
+
+void SimI2CDat::operator=(uint32_t byte) {
+    dat = byte & 0xFF;
+}
+
+SimI2CDat::operator uint32_t() const {
+    return dat;
+}
+
+void NVIC_SetVector(IRQn_Type irq, uintptr_t v) {
+    if (irq == I2C1_IRQn) {
+        vector = (void (*)(void))v;
+    }
+}
+
+void NVIC_EnableIRQ(IRQn_Type irq) {
+    if (irq == I2C1_IRQn) {
+        irqEnabled = true;
+    }
+}
+
+
+void simI2CReset(int slaveAddress) {
+    con = 0;
+    stat = STAT_IDLE;
+    dat = 0;
+    held = false;
+    vector = NULL;
+    irqEnabled = false;
+    slave = slaveAddress & 0xFE;
+    slaveData.clear();
+    readPos = 0;
+    faultArmed = false;
+    simI2CWritten.clear();
+    simI2CStops = 0;
+    simI2CInterrupts = 0;
+}
+
+void simI2CSlaveData(const char *data, int len) {
+    slaveData.assign(data, data + len);
+}
+
+void simI2CInjectFault(SimI2CFault fault, int bytesFromNow) {
+    faultArmed = true;
+    faultKind = fault;
+    faultCountdown = bytesFromNow;
+}
+
+bool simI2CBusHeld(void) {
+    return held;
+}
+
+
+//true (and the fault in kind) if the injected fault hits this byte
+static bool faultHere(SimI2CFault &kind) {
+    if (!faultArmed) {
+        return false;
+    }
+    if (faultCountdown > 0) {
+        faultCountdown--;
+        return false;
+    }
+    faultArmed = false;
+    kind = faultKind;
+    return true;
+}
+
+static void setStat(uint32_t s) {
+    stat = s;
+    con |= I2C_SI;
+}
+
+//one thing happening on the bus, false if it waits for the driver
+static bool busStep(void) {
+    if (!(con & I2C_EN) || (con & I2C_SI)) {
+        return false;
+    }
+    //STOP, followed by a START on the next step if STA is set as well
+    if (con & I2C_STO) {
+        con &= ~I2C_STO;
+        if (held) {
+            held = false;
+            simI2CStops++;
+        }
+        stat = STAT_IDLE;
+        return true;
+    }
+
+    SimI2CFault fault;
+    switch (stat) {
+        case STAT_IDLE:
+            if (!(con & I2C_STA)) {
+                return false;
+            }
+            held = true;
+            setStat(0x08);
+            return true;
+
+        case 0x08: { //SLA+R/W in I2DAT
+            bool read = dat & 0x01;
+            bool ack = (int)(dat & 0xFE) == slave;
+            if (faultHere(fault)) {
+                if (fault == SIM_I2C_BUS_ERROR) {
+                    setStat(0x00);
+                    return true;
+                }
+                ack = false;
+            }
+            if (read) {
+                readPos = 0;
+                setStat(ack ? 0x40 : 0x48);
+            } else {
+                setStat(ack ? 0x18 : 0x20);
+            }
+            return true;
+        }
+
+        case 0x18:
+        case 0x28: //data byte in I2DAT
+            if (faultHere(fault)) {
+                setStat(fault == SIM_I2C_BUS_ERROR ? 0x00 : 0x30);
+                return true;
+            }
+            simI2CWritten.push_back(dat);
+            setStat(0x28);
+            return true;
+
+        case 0x40:
+        case 0x50: //the slave sends, the master ACKs if AA is set
+            if (faultHere(fault) && fault == SIM_I2C_BUS_ERROR) {
+                setStat(0x00);
+                return true;
+            }
+            dat = readPos < slaveData.size() ? slaveData[readPos] : 0xFF;
+            readPos++;
+            setStat((con & I2C_AA) ? 0x50 : 0x58);
+            return true;
+
+        default: //0x58, NACKs and bus errors wait for STO
+            return false;
+    }
+}
+
+
+int simI2CRun(void) {
+    int irqs = 0;
+    for (int i = 0; i < SIM_I2C_MAX_STEPS; i++) {
+        if (con & I2C_SI) {
+            if (!irqEnabled || !vector) {
+                break;
+            }
+            vector();
+            irqs++;
+            simI2CInterrupts++;
+            //SI left set, the bus stays where it is
+            if (con & I2C_SI) {
+                break;
+            }
+            continue;
+        }
+        if (!busStep()) {
+            break;
+        }
+    }
+    return irqs;
+}
@@ -0,0 +1,51 @@
+#ifndef LPC_I2C_SIM_H
+#define LPC_I2C_SIM_H
+
+#include "mbed.h"
+
+//******************************************************************
+// Host model of the LPC176x I2C1 master with one slave on the bus
+//******************************************************************
+//
+// the registers (LPC_I2C1 in host/mbed.h) feed a model of the master
+// state machine from the user manual: STA starts a transfer, every
+// byte on the bus sets SI with the status code of what happened and
+// runs the I2C1 vector (NVIC_SetVector()), clearing SI lets the bus go
+// on, STO releases it. only the codes camera_i2c.cpp sees from a
+// single master are made: 0x08, 0x18, 0x20, 0x28, 0x30, 0x40, 0x48,
+// 0x50, 0x58 and 0x00 (bus error).
+//
+// the slave takes whatever is written to it and answers reads from
+// the bytes given to simI2CSlaveData(). faults are injected by byte:
+// every address or data byte on the bus counts, in bus order.
+
+enum SimI2CFault {
+    SIM_I2C_NACK,       //the slave NACKs the byte (address or written data)
+    SIM_I2C_BUS_ERROR   //status 0x00 instead of the byte
+};
+
+//bus idle, no fault, slave at the 8 bit (write) address, vector and
+//counters cleared
+void simI2CReset(int slaveAddress);
+
+//what the slave sends on reads, from the start every read
+void simI2CSlaveData(const char *data, int len);
+
+//the fault hits the byte bytesFromNow bytes on (0 is the next one)
+void simI2CInjectFault(SimI2CFault fault, int bytesFromNow);
+
+//runs the bus and the interrupt until the bus waits for the driver
+//again (idle, or SI left set), returns the number of interrupts
+int simI2CRun(void);
+
+//true while a transfer holds the bus (from START until STOP)
+bool simI2CBusHeld(void);
+
+//bytes the slave took from writes, register and setup bytes alike
+extern std::vector<unsigned char> simI2CWritten;
+
+//STOPs sent and interrupts run since simI2CReset()
+extern unsigned int simI2CStops;
+extern unsigned int simI2CInterrupts;
+
+#endif
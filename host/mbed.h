@@ -0,0 +1,233 @@
+#ifndef HOST_MBED_H
+#define HOST_MBED_H
+
+//******************************************************************
+// Host (Linux) stand-ins for the parts of mbed the pipeline uses
+//******************************************************************
+//
+// everything runs on a virtual microsecond clock. tickers, timeouts
+// and serial interrupts are "fired" by simStep()/simAdvance() in time
+// order, which plays the part of the NVIC. the host driver runs
+// ghostMouseLoop() between events the same way main() spins between
+// interrupts on the LPC1768.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <math.h>
+#include <vector>
+
+typedef enum {
+    LED1, LED2, LED3, LED4,
+    USBTX, USBRX,
+    p9, p10, p13, p14, p27, p28,
+    NC
+} PinName;
+
+typedef uint32_t timestamp_t;
+
+
+//******************************************************************
+// Virtual clock
+//******************************************************************
+
+//anything that wants to fire at a point in virtual time
+//registers itself on construction
+class SimTimed {
+public:
+    SimTimed();
+    virtual ~SimTimed();
+
+    //true and the time of the next event if one is due
+    virtual bool simPending(uint64_t &at) = 0;
+    virtual void simFire(void) = 0;
+
+    SimTimed *simNext;
+};
+
+//current virtual time in us
+uint64_t simNow(void);
+
+//jumps to the earliest pending event and fires it
+//returns false if nothing is pending
+bool simStep(void);
+
+//fires everything due within the next us microseconds and leaves
+//the clock at now + us
+void simAdvance(uint64_t us);
+
+//back to time zero, used between independent runs
+void simReset(void);
+
+uint32_t us_ticker_read(void);
+
+void wait(float s);
+void wait_ms(int ms);
+void wait_us(int us);
+
+//sleeping until the next interrupt jumps straight to the next event
+//and fires it, with nothing pending at all it returns at once and
+//simStalled() turns true
+void hal_sleep(void);
+bool simStalled(void);
+
+//single threaded, nothing to lock
+inline void core_util_critical_section_enter(void) {}
+inline void core_util_critical_section_exit(void) {}
+
+
+//******************************************************************
+// Drivers
+//******************************************************************
+
+class DigitalOut {
+public:
+    DigitalOut(PinName pin) : _value(0) {}
+    DigitalOut &operator=(int value) { _value = value; return *this; }
+    operator int() { return _value; }
+private:
+    int _value;
+};
+
+
+//the mbed's USB drive, paths go straight to the host's file system
+//(recorderPath has to be pointed somewhere real)
+class LocalFileSystem {
+public:
+    LocalFileSystem(const char *name) {}
+};
+
+
+class SerialBase {
+public:
+    enum IrqType {
+        RxIrq = 0,
+        TxIrq
+    };
+};
+
+
+//serial port that captures everything written to it
+//bytes take 10 bit times at the set baud rate to leave the "UART",
+//writeable() and the TX interrupt follow that timing
+class RawSerial : public SerialBase, public SimTimed {
+public:
+    RawSerial(PinName tx, PinName rx);
+
+    void baud(int baudrate);
+    int putc(int c);
+    int getc(void);
+    int puts(const char *str);
+    int printf(const char *format, ...);
+    int readable(void);
+    int writeable(void);
+    void attach(void (*func)(void), IrqType type = RxIrq);
+
+    virtual bool simPending(uint64_t &at);
+    virtual void simFire(void);
+
+    //bytes that went out and the virtual time each one finished sending
+    std::vector<unsigned char> simTx;
+    std::vector<uint64_t> simTxDoneUs;
+
+    //queues bytes to arrive on RX, one byte time apart
+    void simReceive(const char *data, int len);
+
+private:
+    int _baud;
+    uint64_t _txBusyUntil;
+    bool _txIrqPending;
+    void (*_txIrq)(void);
+    void (*_rxIrq)(void);
+    std::vector<unsigned char> _rx;
+    std::vector<uint64_t> _rxAtUs;
+    size_t _rxHead;
+    uint64_t _byteUs(void);
+};
+
+
+//only pins and clock are set up through it on the firmware, the
+//blocking calls succeed and are counted. setup writes and frame reads
+//go through the camera_i2c stand-in
+class I2C {
+public:
+    I2C(PinName sda, PinName scl) : simWrites(0) {}
+    void frequency(int hz) {}
+    int write(int address, const char *data, int length, bool repeated = false);
+    int read(int address, char *data, int length, bool repeated = false);
+
+    int simWrites;
+};
+
+
+//******************************************************************
+// I2C1 registers
+//******************************************************************
+//
+// the part of the LPC176x I2C1 peripheral camera_i2c.cpp drives, for
+// host/test_camera_i2c, which links it in place of the camera_i2c
+// stand-in. I2CONSET and I2CONCLR set and clear bits of the control
+// register like the hardware, the bus behind them is modelled in
+// host/lpc_i2c_sim.cpp
+
+struct SimI2CConSet {
+    void operator=(uint32_t bits);
+};
+
+struct SimI2CConClr {
+    void operator=(uint32_t bits);
+};
+
+struct SimI2CStat {
+    operator uint32_t() const;
+};
+
+struct SimI2CDat {
+    void operator=(uint32_t byte);
+    operator uint32_t() const;
+};
+
+struct LPC_I2C_TypeDef {
+    SimI2CConSet I2CONSET;
+    SimI2CStat I2STAT;
+    SimI2CDat I2DAT;
+    SimI2CConClr I2CONCLR;
+};
+
+extern LPC_I2C_TypeDef simI2C1;
+#define LPC_I2C1 (&simI2C1)
+
+typedef enum {
+    I2C1_IRQn = 11
+} IRQn_Type;
+
+void NVIC_SetVector(IRQn_Type irq, uintptr_t vector);
+void NVIC_EnableIRQ(IRQn_Type irq);
+
+
+class Ticker : public SimTimed {
+public:
+    Ticker();
+    void attach(void (*func)(void), float t) { attach_us(func, (timestamp_t)(t * 1000000.0f)); }
+    void attach_us(void (*func)(void), timestamp_t t);
+    void detach(void);
+
+    virtual bool simPending(uint64_t &at);
+    virtual void simFire(void);
+
+protected:
+    void (*_func)(void);
+    uint64_t _periodUs;
+    uint64_t _nextUs;
+    bool _oneShot;
+};
+
+
+class Timeout : public Ticker {
+public:
+    Timeout() { _oneShot = true; }
+};
+
+#endif
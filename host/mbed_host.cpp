@@ -0,0 +1,265 @@
+#include "mbed.h"
+
+static uint64_t nowUs = 0;
+static SimTimed *timedList = NULL;
+static bool stalled = false;
+
+
+//******************************************************************
+// Virtual clock
+//******************************************************************
+
+SimTimed::SimTimed() : simNext(timedList) {
+    timedList = this;
+}
+
+SimTimed::~SimTimed() {
+    for (SimTimed **p = &timedList; *p; p = &(*p)->simNext) {
+        if (*p == this) {
+            *p = simNext;
+            break;
+        }
+    }
+}
+
+uint64_t simNow(void) {
+    return nowUs;
+}
+
+//earliest pending event at or before limit, NULL if none
+static SimTimed *nextDue(uint64_t limit, uint64_t &at) {
+    SimTimed *best = NULL;
+    for (SimTimed *t = timedList; t; t = t->simNext) {
+        uint64_t when;
+        if (t->simPending(when) && when <= limit && (!best || when < at)) {
+            best = t;
+            at = when;
+        }
+    }
+    return best;
+}
+
+bool simStep(void) {
+    uint64_t at = 0;
+    SimTimed *t = nextDue(UINT64_MAX, at);
+    if (!t) {
+        return false;
+    }
+    if (at > nowUs) {
+        nowUs = at;
+    }
+    t->simFire();
+    return true;
+}
+
+void simAdvance(uint64_t us) {
+    uint64_t end = nowUs + us;
+    uint64_t at = 0;
+    SimTimed *t;
+    while ((t = nextDue(end, at)) != NULL) {
+        if (at > nowUs) {
+            nowUs = at;
+        }
+        t->simFire();
+    }
+    nowUs = end;
+}
+
+void simReset(void) {
+    nowUs = 0;
+    stalled = false;
+}
+
+uint32_t us_ticker_read(void) {
+    return (uint32_t)nowUs;
+}
+
+void wait(float s) {
+    simAdvance((uint64_t)(s * 1000000.0f));
+}
+
+void wait_ms(int ms) {
+    simAdvance((uint64_t)ms * 1000);
+}
+
+void wait_us(int us) {
+    simAdvance(us);
+}
+
+void hal_sleep(void) {
+    if (!simStep()) {
+        stalled = true;
+    }
+}
+
+bool simStalled(void) {
+    return stalled;
+}
+
+
+//******************************************************************
+// RawSerial
+//******************************************************************
+
+RawSerial::RawSerial(PinName tx, PinName rx)
+    : _baud(9600), _txBusyUntil(0), _txIrqPending(false), _txIrq(NULL), _rxIrq(NULL), _rxHead(0) {
+}
+
+uint64_t RawSerial::_byteUs(void) {
+    //start + 8 data + stop
+    return (10 * 1000000ULL + _baud - 1) / _baud;
+}
+
+void RawSerial::baud(int baudrate) {
+    _baud = baudrate;
+}
+
+int RawSerial::putc(int c) {
+    //blocks like the real putc until the transmitter is free
+    if (_txBusyUntil > nowUs) {
+        simAdvance(_txBusyUntil - nowUs);
+    }
+    _txBusyUntil = nowUs + _byteUs();
+    simTx.push_back((unsigned char)c);
+    simTxDoneUs.push_back(_txBusyUntil);
+    _txIrqPending = true;
+    return c;
+}
+
+int RawSerial::getc(void) {
+    while (!readable()) {
+        if (!simStep()) {
+            return -1;
+        }
+    }
+    return _rx[_rxHead++];
+}
+
+int RawSerial::puts(const char *str) {
+    int n = 0;
+    while (*str) {
+        putc(*str++);
+        n++;
+    }
+    return n;
+}
+
+int RawSerial::printf(const char *format, ...) {
+    char buf[256];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    if (len > (int)sizeof(buf) - 1) {
+        len = sizeof(buf) - 1;
+    }
+    for (int i = 0; i < len; i++) {
+        putc(buf[i]);
+    }
+    return len;
+}
+
+int RawSerial::readable(void) {
+    return _rxHead < _rx.size() && _rxAtUs[_rxHead] <= nowUs;
+}
+
+int RawSerial::writeable(void) {
+    return _txBusyUntil <= nowUs;
+}
+
+void RawSerial::attach(void (*func)(void), IrqType type) {
+    if (type == TxIrq) {
+        _txIrq = func;
+    } else {
+        _rxIrq = func;
+    }
+}
+
+void RawSerial::simReceive(const char *data, int len) {
+    uint64_t at = nowUs;
+    if (!_rxAtUs.empty() && _rxAtUs.back() > at) {
+        at = _rxAtUs.back();
+    }
+    for (int i = 0; i < len; i++) {
+        at += _byteUs();
+        _rx.push_back(data[i]);
+        _rxAtUs.push_back(at);
+    }
+}
+
+bool RawSerial::simPending(uint64_t &at) {
+    bool pending = false;
+    //THRE interrupt once the last byte has left
+    if (_txIrq && _txIrqPending) {
+        at = _txBusyUntil;
+        pending = true;
+    }
+    //RX interrupt for each byte as it arrives
+    if (_rxIrq && _rxHead < _rx.size() && (!pending || _rxAtUs[_rxHead] < at)) {
+        at = _rxAtUs[_rxHead] > nowUs ? _rxAtUs[_rxHead] : nowUs;
+        pending = true;
+    }
+    return pending;
+}
+
+void RawSerial::simFire(void) {
+    if (_rxIrq && readable()) {
+        _rxIrq();
+        return;
+    }
+    if (_txIrq && _txIrqPending && _txBusyUntil <= nowUs) {
+        _txIrqPending = false;
+        _txIrq();
+    }
+}
+
+
+//******************************************************************
+// I2C
+//******************************************************************
+
+int I2C::write(int address, const char *data, int length, bool repeated) {
+    simWrites++;
+    return 0;
+}
+
+int I2C::read(int address, char *data, int length, bool repeated) {
+    memset(data, 0xFF, length);
+    return 0;
+}
+
+
+//******************************************************************
+// Ticker / Timeout
+//******************************************************************
+
+Ticker::Ticker() : _func(NULL), _periodUs(0), _nextUs(0), _oneShot(false) {
+}
+
+void Ticker::attach_us(void (*func)(void), timestamp_t t) {
+    _func = func;
+    _periodUs = t;
+    _nextUs = nowUs + t;
+}
+
+void Ticker::detach(void) {
+    _func = NULL;
+}
+
+bool Ticker::simPending(uint64_t &at) {
+    if (!_func) {
+        return false;
+    }
+    at = _nextUs;
+    return true;
+}
+
+void Ticker::simFire(void) {
+    void (*func)(void) = _func;
+    if (_oneShot) {
+        _func = NULL;
+    } else {
+        _nextUs += _periodUs;
+    }
+    func();
+}
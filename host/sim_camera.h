@@ -0,0 +1,64 @@
+#ifndef SIM_CAMERA_H
+#define SIM_CAMERA_H
+
+#include "camera_i2c.h"
+
+//******************************************************************
+// Scripted IR camera for the host build
+//******************************************************************
+//
+// stands in for camera_i2c.cpp. each cameraStartRead() serves the
+// next scripted frame once the modelled bus time has passed; when the
+// script runs out the camera reports no blobs.
+
+//time one 16 byte read takes on the bus at 400kHz, register write,
+//restart and all
+#define SIM_CAMERA_READ_US 500
+
+//time one two byte setup write takes (address + 2 bytes at 400kHz)
+#define SIM_CAMERA_WRITE_US 70
+
+//setup writes seen so far
+extern int simCameraWrites;
+
+//1023 in both coordinates means no blob in that slot
+#define SIM_NO_POINT 1023
+
+//packs up to four points into the extended mode wire format
+void simCameraEncode(char frame[CAMERA_FRAME_SIZE], const short x[4], const short y[4], const char size[4]);
+
+//appends one raw frame to the script
+void simCameraPush(const char frame[CAMERA_FRAME_SIZE]);
+
+//clears the script and counters
+void simCameraReset(void);
+
+//frames still waiting to be served
+int simCameraRemaining(void);
+
+//loads a text trace, one frame per line: "x1 y1 [x2 y2 [x3 y3 [x4 y4]]]"
+//missing points and "-" are no blob, '#' starts a comment
+//returns the number of frames loaded or -1 if the file can't be opened
+int simCameraLoadTrace(const char *path);
+
+//no blob frames between two sessions of a recording, long enough for
+//every filter and gesture timeout to settle
+#define SIM_SESSION_GAP_FRAMES 100
+
+//true if the file starts like a recorder.h recording
+bool simCameraIsRecording(const char *path);
+
+//loads the raw frames of a recording (recorder.h), all sessions one
+//after the other with SIM_SESSION_GAP_FRAMES blank frames in between.
+//frames are served one per read as usual, the recorded stamps are
+//only checked for gaps (more than 1.5 sample periods)
+//returns the number of frames loaded or -1 if the file can't be
+//opened or is not a recording
+int simCameraLoadRecording(const char *path);
+
+//what the last simCameraLoadRecording() found
+extern int simRecordingSessions;
+extern int simRecordingGaps;
+extern int simRecordingPeriodUs;
+
+#endif
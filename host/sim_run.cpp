@@ -0,0 +1,34 @@
+#include "mbed.h"
+#include "sim_run.h"
+#include "sim_camera.h"
+#include "ghost_mouse.h"
+#include "idle.h"
+
+int simLoadInput(const char *path) {
+    if (simCameraIsRecording(path)) {
+        return simCameraLoadRecording(path);
+    }
+    return simCameraLoadTrace(path);
+}
+
+void simRunPipeline(void) {
+    uint64_t stopUs = 0;
+    //the loop sleeps once it is out of events, which moves the virtual
+    //clock on to the next interrupt
+    while (!simStalled()) {
+        ghostMouseLoop();
+
+        //with sleep off (while recording) the core spins until the
+        //next interrupt instead, which gets there just the same
+        if (!idleSleepEnabled) {
+            hal_sleep();
+        }
+
+        if (stopUs == 0 && simCameraRemaining() == 0) {
+            stopUs = simNow() + SIM_TAIL_US;
+        }
+        if (stopUs != 0 && simNow() >= stopUs) {
+            break;
+        }
+    }
+}
@@ -0,0 +1,23 @@
+#ifndef SIM_RUN_H
+#define SIM_RUN_H
+
+//******************************************************************
+// Runs a camera input through the pipeline on the virtual clock
+//******************************************************************
+//
+// shared by ghost_mouse_host and the host tests
+
+//how long to keep running after the input ran out, so queued
+//reports and pending clicks still go out
+#define SIM_TAIL_US 200000
+
+//loads a text trace or a recording (told apart by the recording
+//header) into the scripted camera
+//returns the number of frames or -1 if the file can't be read
+int simLoadInput(const char *path);
+
+//runs ghostMouseLoop() until the camera script is used up and
+//SIM_TAIL_US after that, ghostMouseSetup() has to have been called
+void simRunPipeline(void);
+
+#endif
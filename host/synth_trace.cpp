@@ -0,0 +1,217 @@
+#include "mbed.h"
+#include "synth_trace.h"
+#include "sim_camera.h"
+#include "ir_frame.h"
+
+//usable area, away from the edges so strokes have room
+#define SYNTH_X_MIN 100
+#define SYNTH_X_MAX 920
+#define SYNTH_Y_MIN 80
+#define SYNTH_Y_MAX 680
+
+//finger spacing of the two finger scroll
+#define SYNTH_SCROLL_SPACING 100
+
+//frames of a flick stroke, it reaches full speed at the end
+#define SYNTH_FLICK_FRAMES 12
+
+static const char *const motionNames[SYNTH_MOTION_COUNT] = {
+    "flick",
+    "slow_drag",
+    "tap",
+    "scroll",
+    "still",
+    "four_blobs"
+};
+
+static SynthParams params;
+static unsigned int seed;
+
+//where the blobs are and where they are heading, in counts
+static double posX[4], posY[4];
+static double velX[4], velY[4];
+static int blobs;           //blobs down this frame, 0 while lifted
+static int strokeFrame;     //frames into the current stroke
+static int framesLeft;      //frames until the next stroke or pause
+
+
+static int randomInt(int n) {
+    seed = seed * 1103515245 + 12345;
+    return n > 0 ? (int)((seed >> 8) % n) : 0;
+}
+
+//uniform in lo..hi
+static int randomRange(int lo, int hi) {
+    return lo + randomInt(hi - lo + 1);
+}
+
+//random direction at the given speed
+static void randomVelocity(double speed, double &vx, double &vy) {
+    double angle = randomInt(3600) * (2 * M_PI / 3600);
+    vx = speed * cos(angle);
+    vy = speed * sin(angle);
+}
+
+
+void synthDefaults(SynthMotion motion, SynthParams &p) {
+    p.motion = motion;
+    p.speed = 20;
+    p.noise = 1;
+    p.dropoutPermille = 0;
+    p.seed = 1;
+    if (motion == SYNTH_STILL) {
+        p.noise = 3;
+    } else if (motion == SYNTH_FOUR_BLOBS) {
+        p.speed = 30;
+        p.noise = 2;
+        p.dropoutPermille = 20;
+    }
+}
+
+
+void synthStart(const SynthParams &p) {
+    params = p;
+    seed = p.seed;
+    blobs = 0;
+    strokeFrame = 0;
+    framesLeft = 0;
+}
+
+
+//next stroke (fingers down) or pause (lifted) of the motion
+static void nextPhase(void) {
+    strokeFrame = 0;
+    double speed = params.speed;
+
+    //every motion but these two pauses between strokes
+    bool continuous = params.motion == SYNTH_STILL || params.motion == SYNTH_FOUR_BLOBS;
+    if (blobs > 0 && !continuous) {
+        blobs = 0;
+        framesLeft = randomRange(20, 40);
+        return;
+    }
+
+    //the four blobs only change direction, they carry on from where
+    //they are
+    if (params.motion == SYNTH_FOUR_BLOBS && blobs == 4) {
+        for (int i = 0; i < 4; i++) {
+            randomVelocity(randomRange(1, params.speed), velX[i], velY[i]);
+        }
+        framesLeft = randomRange(20, 60);
+        return;
+    }
+
+    posX[0] = randomRange(SYNTH_X_MIN, SYNTH_X_MAX);
+    posY[0] = randomRange(SYNTH_Y_MIN, SYNTH_Y_MAX);
+    velX[0] = velY[0] = 0;
+    blobs = 1;
+
+    switch (params.motion) {
+    case SYNTH_FLICK:
+        randomVelocity(speed, velX[0], velY[0]);
+        framesLeft = SYNTH_FLICK_FRAMES;
+        break;
+    case SYNTH_SLOW_DRAG:
+        randomVelocity(speed > 4 ? speed / 4 : 1, velX[0], velY[0]);
+        framesLeft = randomRange(100, 200);
+        break;
+    case SYNTH_TAP:
+        framesLeft = randomRange(12, 30);
+        break;
+    case SYNTH_SCROLL:
+        blobs = 2;
+        posX[1] = posX[0] + SYNTH_SCROLL_SPACING;
+        posY[1] = posY[0];
+        //mostly vertical, sometimes sideways
+        if (randomInt(4) == 0) {
+            velX[0] = randomInt(2) ? speed / 2 : -speed / 2;
+            velY[0] = 0;
+        } else {
+            velX[0] = 0;
+            velY[0] = randomInt(2) ? speed / 2 : -speed / 2;
+        }
+        velX[1] = velX[0];
+        velY[1] = velY[0];
+        framesLeft = randomRange(40, 80);
+        break;
+    case SYNTH_STILL:
+        framesLeft = 0x7FFFFFFF;
+        break;
+    case SYNTH_FOUR_BLOBS:
+        blobs = 4;
+        for (int i = 0; i < 4; i++) {
+            posX[i] = randomRange(SYNTH_X_MIN, SYNTH_X_MAX);
+            posY[i] = randomRange(SYNTH_Y_MIN, SYNTH_Y_MAX);
+            randomVelocity(randomRange(1, params.speed), velX[i], velY[i]);
+        }
+        framesLeft = randomRange(20, 60);
+        break;
+    default:
+        break;
+    }
+}
+
+
+void synthFrame(char frame[CAMERA_FRAME_SIZE]) {
+    if (framesLeft <= 0) {
+        nextPhase();
+    }
+    framesLeft--;
+    strokeFrame++;
+
+    short x[4], y[4];
+    char size[4];
+    for (int i = 0; i < 4; i++) {
+        x[i] = SIM_NO_POINT;
+        y[i] = SIM_NO_POINT;
+        size[i] = 0x0F;
+        if (i >= blobs) {
+            continue;
+        }
+
+        //flicks speed up over the stroke
+        double scale = 1;
+        if (params.motion == SYNTH_FLICK) {
+            scale = (double)strokeFrame / SYNTH_FLICK_FRAMES;
+        }
+        posX[i] += velX[i] * scale;
+        posY[i] += velY[i] * scale;
+
+        //turn around at the edges
+        if (posX[i] < 0 || posX[i] > IR_NO_POINT - 1) {
+            velX[i] = -velX[i];
+            posX[i] = posX[i] < 0 ? 0 : IR_NO_POINT - 1;
+        }
+        if (posY[i] < 0 || posY[i] > 767) {
+            velY[i] = -velY[i];
+            posY[i] = posY[i] < 0 ? 0 : 767;
+        }
+
+        if (randomInt(1000) < params.dropoutPermille) {
+            continue;
+        }
+        int jx = (int)posX[i] + randomRange(-params.noise, params.noise);
+        int jy = (int)posY[i] + randomRange(-params.noise, params.noise);
+        x[i] = jx < 0 ? 0 : (jx > IR_NO_POINT - 1 ? IR_NO_POINT - 1 : jx);
+        y[i] = jy < 0 ? 0 : (jy > 767 ? 767 : jy);
+        size[i] = 3;
+    }
+
+    simCameraEncode(frame, x, y, size);
+}
+
+
+const char *synthMotionName(SynthMotion motion) {
+    return motionNames[motion];
+}
+
+
+bool synthMotionByName(const char *name, SynthMotion &motion) {
+    for (int i = 0; i < SYNTH_MOTION_COUNT; i++) {
+        if (strcmp(name, motionNames[i]) == 0) {
+            motion = (SynthMotion)i;
+            return true;
+        }
+    }
+    return false;
+}
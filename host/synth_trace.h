@@ -0,0 +1,52 @@
+#ifndef SYNTH_TRACE_H
+#define SYNTH_TRACE_H
+
+#include "camera_i2c.h"
+
+//******************************************************************
+// Synthetic finger traces
+//******************************************************************
+//
+// makes up camera frames in the extended mode wire format for a few
+// kinds of motion, each repeated as often as frames are asked for
+// (land, move, lift, pause, over again). the direction, length and
+// position of every repeat are random, from the seed, so the same
+// parameters always give the same frames.
+//
+// noise and dropouts go on top of any motion: every blob coordinate
+// gets up to +-noise counts of jitter, and each blob is missing from a
+// frame with a chance of dropoutPermille / 1000.
+
+enum SynthMotion {
+    SYNTH_FLICK,        //short, fast strokes that speed up and lift while moving
+    SYNTH_SLOW_DRAG,    //long strokes at a fraction of the speed
+    SYNTH_TAP,          //finger down briefly without moving
+    SYNTH_SCROLL,       //two fingers side by side moving together
+    SYNTH_STILL,        //one finger resting in one place the whole time
+    SYNTH_FOUR_BLOBS,   //worst case: four blobs moving independently
+    SYNTH_MOTION_COUNT
+};
+
+struct SynthParams {
+    SynthMotion motion;
+    int speed;              //counts per frame at full speed
+    int noise;              //+- counts of jitter
+    int dropoutPermille;    //chance a blob is missing from a frame
+    unsigned int seed;
+};
+
+//parameters a motion is generated with unless told otherwise
+void synthDefaults(SynthMotion motion, SynthParams &params);
+
+//starts a new sequence
+void synthStart(const SynthParams &params);
+
+//next frame of the sequence
+void synthFrame(char frame[CAMERA_FRAME_SIZE]);
+
+const char *synthMotionName(SynthMotion motion);
+
+//false if there is no motion of that name
+bool synthMotionByName(const char *name, SynthMotion &motion);
+
+#endif
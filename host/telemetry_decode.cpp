@@ -0,0 +1,183 @@
+#include <stdio.h>
+#include <string.h>
+#include "telemetry.h"
+#include "gesture.h"
+
+//******************************************************************
+// Decodes a telemetry stream (telemetry.h) into CSV
+//******************************************************************
+//
+// usage: telemetry_decode <stream.bin> <raw|track|gesture|report>
+//
+// prints the records of the chosen type as CSV on stdout, one line
+// per record. frames that fail to decode or whose checksum is off are
+// skipped, and a summary (records per type, bad frames, records lost
+// going by the sequence numbers) goes to stderr.
+//
+// the stream can be a capture of the pc port with 't' switched on,
+// or the file ghost_mouse_host writes with its second argument.
+
+struct RecordType {
+    const char *name;
+    TelemetryType type;
+    int payloadSize;
+    const char *header;
+};
+
+static const RecordType recordTypes[] = {
+    {"raw", TEL_RAW, TEL_RAW_SIZE,
+     "seq,stamp_us,x0,y0,size0,x1,y1,size1,x2,y2,size2,x3,y3,size3"},
+    {"track", TEL_TRACK, TEL_TRACK_SIZE,
+     "seq,stamp_us,valid,x0,y0,x1,y1,x2,y2,x3,y3"},
+    {"gesture", TEL_GESTURE, TEL_GESTURE_SIZE,
+     "seq,stamp_us,state,from"},
+    {"report", TEL_REPORT, TEL_REPORT_SIZE,
+     "seq,stamp_us,buttons,x,y,wheel,pan"},
+};
+
+#define RECORD_TYPES (int)(sizeof(recordTypes) / sizeof(recordTypes[0]))
+
+
+static unsigned int get16(const unsigned char *p) {
+    return p[0] | (p[1] << 8);
+}
+
+static unsigned int get32(const unsigned char *p) {
+    return get16(p) | (get16(p + 2) << 16);
+}
+
+static const RecordType *findType(int type) {
+    for (int i = 0; i < RECORD_TYPES; i++) {
+        if (recordTypes[i].type == type) {
+            return &recordTypes[i];
+        }
+    }
+    return NULL;
+}
+
+static const char *stateName(int state) {
+    if (state < 0 || state >= GESTURE_STATE_COUNT) {
+        return "?";
+    }
+    return gestureStateName((GestureState)state);
+}
+
+
+//one CSV line, payload already checked for size
+static void printRecord(TelemetryType type, unsigned int seq, unsigned int stampUs, const unsigned char *p) {
+    printf("%u,%u", seq, stampUs);
+    switch (type) {
+    case TEL_RAW:
+        for (int i = 0; i < IR_MAX_POINTS; i++, p += 5) {
+            printf(",%u,%u,%u", get16(p), get16(p + 2), p[4]);
+        }
+        break;
+    case TEL_TRACK: {
+        unsigned char valid = *p++;
+        printf(",%u", valid);
+        for (int i = 0; i < IR_MAX_POINTS; i++, p += 8) {
+            //Q8 to pixels, empty for slots without a contact
+            if ((valid >> i) & 1) {
+                printf(",%.3f,%.3f", (int)get32(p) / 256.0, (int)get32(p + 4) / 256.0);
+            } else {
+                printf(",,");
+            }
+        }
+        break;
+    }
+    case TEL_GESTURE:
+        printf(",%s,%s", stateName(p[0]), stateName(p[1]));
+        break;
+    case TEL_REPORT:
+        printf(",%02X,%d,%d,%d,%d", p[0], (signed char)p[1], (signed char)p[2],
+               (signed char)p[3], (signed char)p[4]);
+        break;
+    }
+    printf("\n");
+}
+
+
+int main(int argc, char **argv) {
+    const RecordType *want = NULL;
+    if (argc == 3) {
+        for (int i = 0; i < RECORD_TYPES; i++) {
+            if (strcmp(argv[2], recordTypes[i].name) == 0) {
+                want = &recordTypes[i];
+            }
+        }
+    }
+    if (!want) {
+        fprintf(stderr, "usage: %s <stream.bin> <raw|track|gesture|report>\n", argv[0]);
+        return 2;
+    }
+
+    FILE *in = fopen(argv[1], "rb");
+    if (!in) {
+        fprintf(stderr, "can't open %s\n", argv[1]);
+        return 1;
+    }
+
+    printf("%s\n", want->header);
+
+    unsigned int counts[RECORD_TYPES] = {0};
+    unsigned int badFrames = 0;
+    unsigned int lost = 0;
+    bool haveSequence = false;
+    unsigned int nextSequence = 0;
+
+    //frames longer than the largest record are garbage, they are
+    //collected up to the limit and then thrown away
+    unsigned char frame[TEL_FRAME_MAX + 1];
+    unsigned char record[TEL_FRAME_MAX + 1];
+    int len = 0;
+    bool overlong = false;
+    int c;
+    while ((c = fgetc(in)) != EOF) {
+        if (c != 0) {
+            if (len < (int)sizeof(frame)) {
+                frame[len++] = c;
+            } else {
+                overlong = true;
+            }
+            continue;
+        }
+
+        //delimiter, decode what came before it
+        int n = overlong ? -1 : cobsDecode(frame, len, record);
+        bool empty = len == 0;
+        len = 0;
+        overlong = false;
+        if (empty) {
+            continue;
+        }
+
+        unsigned char sum = 0;
+        for (int i = 0; i < n; i++) {
+            sum += record[i];
+        }
+        const RecordType *type = n > TEL_HEADER_SIZE ? findType(record[0]) : NULL;
+        if (n < 0 || sum != 0 || !type || n != TEL_HEADER_SIZE + type->payloadSize + 1) {
+            badFrames++;
+            continue;
+        }
+
+        unsigned int seq = get16(record + 1);
+        if (haveSequence) {
+            lost += (seq - nextSequence) & 0xFFFF;
+        }
+        haveSequence = true;
+        nextSequence = (seq + 1) & 0xFFFF;
+
+        counts[type - recordTypes]++;
+        if (type == want) {
+            printRecord(type->type, seq, get32(record + 3), record + TEL_HEADER_SIZE);
+        }
+    }
+    fclose(in);
+
+    for (int i = 0; i < RECORD_TYPES; i++) {
+        fprintf(stderr, "%s=%u ", recordTypes[i].name, counts[i]);
+    }
+    fprintf(stderr, "bad=%u lost=%u\n", badFrames, lost);
+    return 0;
+}
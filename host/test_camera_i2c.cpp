@@ -0,0 +1,146 @@
+#include "mbed.h"
+#include "camera_i2c.h"
+#include "lpc_i2c_sim.h"
+
+//******************************************************************
+// Host test: the register level camera driver
+//******************************************************************
+//
+// usage: test_camera_i2c
+//
+// runs camera_i2c.cpp itself, not the camera_i2c stand-in the other
+// host programs use, against the model of I2C1 in host/lpc_i2c_sim.h
+// and checks that
+//  - a read writes the data register and brings back the frame
+//  - a setup write puts its bytes on the bus
+//  - a NACK of the address, of SLA+R or of a setup byte, and a bus
+//    error in the middle of a read, each end the transfer with a STOP,
+//    count one bus error and publish nothing, and the next read works
+//  - a read while the bus is busy is skipped, a frame that is replaced
+//    before it was taken is counted
+// exits non-zero on failure.
+
+//8 bit write address of the camera, ghost_mouse.cpp
+#define CAMERA_ADDRESS 0xB0
+
+//register the frame is read from, camera_i2c.cpp
+#define CAMERA_DATA_REG 0x36
+
+//bytes on the bus before the data of a read: SLA+W, register, SLA+R
+#define READ_HEADER_BYTES 3
+
+static int failures = 0;
+
+static void check(bool ok, const char *name, const char *what, long long got, long long want) {
+    if (!ok) {
+        printf("FAIL %s, %s: got %lld, want %lld\n", name, what, got, want);
+        failures++;
+    }
+}
+
+
+static char slaveFrame[CAMERA_FRAME_SIZE];
+static int framesPublished = 0;
+
+static void onFrame(void) {
+    framesPublished++;
+}
+
+
+//a read that has to go through
+static void checkRead(const char *name) {
+    unsigned int errors = cameraBusErrors;
+    int published = framesPublished;
+    simI2CWritten.clear();
+
+    check(cameraStartRead(), name, "read started", 0, 1);
+    simI2CRun();
+
+    char frame[CAMERA_FRAME_SIZE];
+    check(framesPublished == published + 1, name, "frames published", framesPublished, published + 1);
+    check(cameraTakeFrame(frame), name, "frame taken", 0, 1);
+    check(memcmp(frame, slaveFrame, CAMERA_FRAME_SIZE) == 0, name, "frame bytes", frame[0], slaveFrame[0]);
+    check(simI2CWritten.size() == 1 && simI2CWritten[0] == CAMERA_DATA_REG, name, "register written",
+          simI2CWritten.empty() ? -1 : simI2CWritten[0], CAMERA_DATA_REG);
+    check(cameraBusErrors == errors, name, "bus errors", cameraBusErrors, errors);
+    check(cameraBusIdle(), name, "driver idle", 0, 1);
+    check(!simI2CBusHeld(), name, "bus released", 1, 0);
+}
+
+//a transfer started with a fault injected, that has to be given up
+static void checkAborted(const char *name, bool started) {
+    unsigned int errors = cameraBusErrors;
+    unsigned int stops = simI2CStops;
+    int published = framesPublished;
+
+    check(started, name, "transfer started", 0, 1);
+    simI2CRun();
+
+    check(cameraBusErrors == errors + 1, name, "bus errors", cameraBusErrors, errors + 1);
+    check(simI2CStops > stops, name, "STOP sent", simI2CStops, stops + 1);
+    check(framesPublished == published, name, "frames published", framesPublished, published);
+    check(!cameraFrameReady(), name, "frame ready", 1, 0);
+    check(cameraBusIdle(), name, "driver idle", 0, 1);
+    check(!simI2CBusHeld(), name, "bus released", 1, 0);
+}
+
+
+int main(void) {
+    for (int i = 0; i < CAMERA_FRAME_SIZE; i++) {
+        slaveFrame[i] = 0x10 + i;
+    }
+    simI2CReset(CAMERA_ADDRESS);
+    simI2CSlaveData(slaveFrame, CAMERA_FRAME_SIZE);
+    cameraI2CInit(CAMERA_ADDRESS, &onFrame);
+
+    checkRead("read");
+
+    //setup write
+    const char setup[2] = {0x30, 0x01};
+    simI2CWritten.clear();
+    check(cameraStartWrite(setup, 2), "setup write", "started", 0, 1);
+    simI2CRun();
+    check(simI2CWritten.size() == 2 && simI2CWritten[0] == 0x30 && simI2CWritten[1] == 0x01,
+          "setup write", "bytes written", simI2CWritten.size(), 2);
+    check(cameraBusErrors == 0, "setup write", "bus errors", cameraBusErrors, 0);
+    check(!cameraFrameReady(), "setup write", "frame ready", 1, 0);
+    check(cameraBusIdle() && !simI2CBusHeld(), "setup write", "idle", 0, 1);
+
+    //camera not answering
+    simI2CInjectFault(SIM_I2C_NACK, 0);
+    checkAborted("nack address", cameraStartRead());
+    checkRead("read after nack address");
+
+    simI2CInjectFault(SIM_I2C_NACK, 2);
+    checkAborted("nack SLA+R", cameraStartRead());
+    checkRead("read after nack SLA+R");
+
+    simI2CInjectFault(SIM_I2C_NACK, 2);
+    checkAborted("nack setup byte", cameraStartWrite(setup, 2));
+    checkRead("read after nack setup byte");
+
+    //half a frame, then the bus error
+    simI2CInjectFault(SIM_I2C_BUS_ERROR, READ_HEADER_BYTES + CAMERA_FRAME_SIZE / 2);
+    checkAborted("bus error", cameraStartRead());
+    checkRead("read after bus error");
+
+    //a read while the last one is still going
+    unsigned int skipped = cameraReadsSkipped;
+    check(cameraStartRead(), "busy", "first read started", 0, 1);
+    check(!cameraStartRead(), "busy", "second read started", 1, 0);
+    check(!cameraStartWrite(setup, 2), "busy", "write started", 1, 0);
+    check(cameraReadsSkipped == skipped + 1, "busy", "reads skipped", cameraReadsSkipped, skipped + 1);
+    simI2CRun();
+
+    //the frame of that read was never taken
+    unsigned int dropped = cameraFramesDropped;
+    checkRead("read over an untaken frame");
+    check(cameraFramesDropped == dropped + 1, "read over an untaken frame", "frames dropped",
+          cameraFramesDropped, dropped + 1);
+
+    if (failures) {
+        return 1;
+    }
+    printf("PASS: %u interrupts, %u bus errors, %u STOPs\n", simI2CInterrupts, cameraBusErrors, simI2CStops);
+    return 0;
+}
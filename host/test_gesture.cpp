@@ -0,0 +1,59 @@
+#include "mbed.h"
+#include "gesture.h"
+#include "ir_frame.h"
+
+//******************************************************************
+// Host test: tap duration limits
+//******************************************************************
+//
+// usage: test_gesture
+//
+// lands a finger, keeps it still and lifts it, for every touch length
+// from below tapMinFrames to past tapMaxFrames, and checks that only
+// touches strictly between the two limits tap (gesture.h), the
+// lengths right at each limit included. the touch length is
+// stateFrames at the lift: the frames after the landing one.
+// exits non-zero on failure.
+
+static int failures = 0;
+
+static void check(bool ok, const char *what, long long got, long long want) {
+    if (!ok) {
+        printf("FAIL %s: got %lld, want %lld\n", what, got, want);
+        failures++;
+    }
+}
+
+
+//taps reported for a touch of the given length
+static int touch(int frames) {
+    IRFrame down, up;
+    clearIRFrame(down);
+    clearIRFrame(up);
+    down.point[0].x = 500;
+    down.point[0].y = 400;
+    down.point[0].size = 3;
+    down.valid = 0x01;
+
+    resetGesture();
+    int taps = 0;
+    for (int i = 0; i <= frames; i++) {
+        taps += updateGesture(down, 0) & GESTURE_OUT_TAP ? 1 : 0;
+    }
+    taps += updateGesture(up, 0) & GESTURE_OUT_TAP ? 1 : 0;
+    return taps;
+}
+
+
+int main(void) {
+    for (int frames = tapMinFrames - 2; frames <= tapMaxFrames + 2; frames++) {
+        int want = frames > tapMinFrames && frames < tapMaxFrames ? 1 : 0;
+        char what[32];
+        snprintf(what, sizeof(what), "taps, %d frames", frames);
+        check(touch(frames) == want, what, touch(frames), want);
+    }
+
+    printf("%s: taps between %d and %d frames\n", failures ? "FAIL" : "PASS",
+           tapMinFrames, tapMaxFrames);
+    return failures ? 1 : 0;
+}
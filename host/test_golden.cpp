@@ -0,0 +1,537 @@
+#include "mbed.h"
+#include "ghost_mouse.h"
+#include "sim_run.h"
+#include "sim_camera.h"
+#include "synth_trace.h"
+
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <string>
+#include <algorithm>
+
+//******************************************************************
+// Host test: golden report streams for the trace corpus
+//******************************************************************
+//
+// usage: test_golden [--update]
+//
+// runs every trace in host/traces (text traces and recordings) through
+// the pipeline and compares the report bytes that left keyOut, with
+// the time each report finished, against host/golden/<trace>.golden.
+//
+// a stream that matches byte for byte passes. one that does not is
+// compared with some tolerance, so a filter tweak that moves a report
+// by a frame does not need new goldens, while a change in cursor feel
+// or click recognition does:
+//  - the cumulative path (x, y, wheel, pan) may not be further than
+//    PATH_TOLERANCE counts from the golden path at any time, looking
+//    TIME_TOLERANCE_US either side, and has to end within it too
+//  - the button changes have to be the same, each within
+//    TIME_TOLERANCE_US of the golden one
+// what differs is printed either way.
+//
+// also times the processing per frame of each trace (host CPU, best of
+// TIMING_RUNS). absolute times only mean something on the machine that
+// took them, so each trace is timed against a reference run in the same
+// test, REFERENCE_FRAMES synthetic flick frames (synth_trace.h, as in
+// the bench), and the golden file keeps that ratio. a trace more than
+// SLOW_FACTOR times its golden ratio gets a warning.
+//
+// --update writes new golden files instead of checking.
+// exits non-zero on failure.
+
+#define TRACE_DIR "host/traces"
+#define GOLDEN_DIR "host/golden"
+
+#define REPORT_SIZE 9
+
+#define PATH_TOLERANCE 4
+#define TIME_TOLERANCE_US 50000
+
+#define TIMING_RUNS 3
+#define SLOW_FACTOR 3
+#define REFERENCE_FRAMES 2000
+
+struct Report {
+    unsigned long long doneUs;
+    unsigned char bytes[REPORT_SIZE];
+};
+
+struct RunResult {
+    bool ok;
+    int frames;
+    unsigned long long cpuNs;
+    std::vector<Report> reports;
+};
+
+struct Golden {
+    bool ok;
+    unsigned int costPercent;       //ns per frame, % of the reference
+    std::vector<Report> reports;
+};
+
+//cumulative motion after a report
+struct PathPoint {
+    unsigned long long us;
+    long long v[4];     //x, y, wheel, pan
+};
+
+
+//******************************************************************
+// Running a trace
+//******************************************************************
+
+static bool writeAll(int fd, const void *data, size_t len) {
+    const char *p = (const char *)data;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        len -= n;
+    }
+    return true;
+}
+
+static bool readAll(int fd, void *data, size_t len) {
+    char *p = (char *)data;
+    while (len > 0) {
+        ssize_t n = read(fd, p, len);
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        len -= n;
+    }
+    return true;
+}
+
+static unsigned long long cpuNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+//the timing reference, synthetic flicks
+static int loadReference(void) {
+    SynthParams params;
+    synthDefaults(SYNTH_FLICK, params);
+    synthStart(params);
+    for (int f = 0; f < REFERENCE_FRAMES; f++) {
+        char data[CAMERA_FRAME_SIZE];
+        synthFrame(data);
+        simCameraPush(data);
+    }
+    return REFERENCE_FRAMES;
+}
+
+//the pipeline lives in globals, so each run gets a fresh process
+//(fork) and sends its keyOut bytes back through a pipe
+//an empty path runs the timing reference
+static RunResult runTrace(const std::string &path) {
+    RunResult result;
+    result.ok = false;
+    result.frames = 0;
+    result.cpuNs = 0;
+
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return result;
+    }
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return result;
+    }
+
+    if (pid == 0) {
+        close(fds[0]);
+        int frames = path.empty() ? loadReference() : simLoadInput(path.c_str());
+        if (frames < 0) {
+            _exit(1);
+        }
+        ghostMouseSetup();
+        unsigned long long start = cpuNow();
+        simRunPipeline();
+        unsigned long long cpuNs = cpuNow() - start;
+
+        unsigned int bytes = keyOut.simTx.size();
+        bool sent = writeAll(fds[1], &frames, sizeof(frames))
+            && writeAll(fds[1], &cpuNs, sizeof(cpuNs))
+            && writeAll(fds[1], &bytes, sizeof(bytes));
+        if (sent && bytes > 0) {
+            sent = writeAll(fds[1], &keyOut.simTx[0], bytes)
+                && writeAll(fds[1], &keyOut.simTxDoneUs[0], bytes * sizeof(uint64_t));
+        }
+        _exit(sent ? 0 : 1);
+    }
+
+    close(fds[1]);
+    unsigned int bytes = 0;
+    bool ok = readAll(fds[0], &result.frames, sizeof(result.frames))
+        && readAll(fds[0], &result.cpuNs, sizeof(result.cpuNs))
+        && readAll(fds[0], &bytes, sizeof(bytes));
+    std::vector<unsigned char> tx(bytes);
+    std::vector<uint64_t> doneUs(bytes);
+    if (ok && bytes > 0) {
+        ok = readAll(fds[0], &tx[0], bytes) && readAll(fds[0], &doneUs[0], bytes * sizeof(uint64_t));
+    }
+    close(fds[0]);
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (!ok || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        return result;
+    }
+
+    //whole reports only, a stray byte is kept as a report of its own
+    //so it shows up as a difference
+    for (size_t i = 0; i < tx.size(); ) {
+        Report r;
+        memset(r.bytes, 0, sizeof(r.bytes));
+        size_t len = (tx[i] == 0xFD && i + REPORT_SIZE <= tx.size()) ? REPORT_SIZE : 1;
+        memcpy(r.bytes, &tx[i], len);
+        r.doneUs = doneUs[i + len - 1];
+        result.reports.push_back(r);
+        i += len;
+    }
+    result.ok = true;
+    return result;
+}
+
+
+static unsigned long long nsPerFrame(const RunResult &run) {
+    return run.frames ? run.cpuNs / run.frames : 0;
+}
+
+//the run, and the fastest of TIMING_RUNS - 1 more for the time
+static RunResult runTimed(const std::string &path) {
+    RunResult run = runTrace(path);
+    for (int i = 1; i < TIMING_RUNS && run.ok; i++) {
+        RunResult again = runTrace(path);
+        if (again.ok && again.cpuNs < run.cpuNs) {
+            run.cpuNs = again.cpuNs;
+        }
+    }
+    return run;
+}
+
+
+//******************************************************************
+// Golden files
+//******************************************************************
+
+static std::string goldenPath(const std::string &trace) {
+    return std::string(GOLDEN_DIR) + "/" + trace + ".golden";
+}
+
+static bool writeGolden(const std::string &trace, const RunResult &run, unsigned int costPercent) {
+    FILE *f = fopen(goldenPath(trace).c_str(), "w");
+    if (!f) {
+        return false;
+    }
+    fprintf(f, "# reports of %s/%s, time the last byte left keyOut (us) and the bytes\n", TRACE_DIR, trace.c_str());
+    fprintf(f, "# regenerate with make -f Makefile.host golden\n");
+    fprintf(f, "cost_percent %u\n", costPercent);
+    for (size_t i = 0; i < run.reports.size(); i++) {
+        fprintf(f, "%llu ", run.reports[i].doneUs);
+        for (int b = 0; b < REPORT_SIZE; b++) {
+            fprintf(f, "%02X", run.reports[i].bytes[b]);
+        }
+        fprintf(f, "\n");
+    }
+    fclose(f);
+    return true;
+}
+
+static Golden readGolden(const std::string &trace) {
+    Golden golden;
+    golden.ok = false;
+    golden.costPercent = 0;
+
+    FILE *f = fopen(goldenPath(trace).c_str(), "r");
+    if (!f) {
+        return golden;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        if (line[0] == '#') {
+            continue;
+        }
+        if (sscanf(line, "cost_percent %u", &golden.costPercent) == 1) {
+            continue;
+        }
+        Report r;
+        char hex[2 * REPORT_SIZE + 1];
+        if (sscanf(line, "%llu %18s", &r.doneUs, hex) != 2 || strlen(hex) != 2 * REPORT_SIZE) {
+            continue;
+        }
+        for (int b = 0; b < REPORT_SIZE; b++) {
+            unsigned int v;
+            sscanf(hex + 2 * b, "%2x", &v);
+            r.bytes[b] = v;
+        }
+        golden.reports.push_back(r);
+    }
+    fclose(f);
+    golden.ok = true;
+    return golden;
+}
+
+
+//******************************************************************
+// Comparison
+//******************************************************************
+
+static bool sameReports(const std::vector<Report> &a, const std::vector<Report> &b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].doneUs != b[i].doneUs || memcmp(a[i].bytes, b[i].bytes, REPORT_SIZE) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool isReport(const Report &r) {
+    return r.bytes[0] == 0xFD && r.bytes[1] == 0x00 && r.bytes[2] == 0x03;
+}
+
+static std::vector<PathPoint> cumulativePath(const std::vector<Report> &reports) {
+    std::vector<PathPoint> path;
+    PathPoint p;
+    memset(&p, 0, sizeof(p));
+    for (size_t i = 0; i < reports.size(); i++) {
+        if (!isReport(reports[i])) {
+            continue;
+        }
+        p.us = reports[i].doneUs;
+        for (int k = 0; k < 4; k++) {
+            p.v[k] += (signed char)reports[i].bytes[4 + k];
+        }
+        path.push_back(p);
+    }
+    return path;
+}
+
+static long long distance(const PathPoint &a, const PathPoint &b) {
+    long long d = 0;
+    for (int k = 0; k < 4; k++) {
+        d = std::max(d, a.v[k] > b.v[k] ? a.v[k] - b.v[k] : b.v[k] - a.v[k]);
+    }
+    return d;
+}
+
+//largest distance from a point of a to the closest point of b within
+//TIME_TOLERANCE_US of it (including where b stood when that window
+//opened), and the point of a where it is
+static long long pathDeviation(const std::vector<PathPoint> &a, const std::vector<PathPoint> &b, size_t &worst) {
+    long long deviation = 0;
+    worst = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        unsigned long long from = a[i].us > TIME_TOLERANCE_US ? a[i].us - TIME_TOLERANCE_US : 0;
+        unsigned long long to = a[i].us + TIME_TOLERANCE_US;
+
+        PathPoint origin;
+        memset(&origin, 0, sizeof(origin));
+        long long best = -1;
+        for (size_t j = 0; j < b.size() && b[j].us <= to; j++) {
+            if (b[j].us < from) {
+                origin = b[j];
+                continue;
+            }
+            long long d = distance(a[i], b[j]);
+            if (best < 0 || d < best) {
+                best = d;
+            }
+        }
+        long long d = distance(a[i], origin);
+        if (best < 0 || d < best) {
+            best = d;
+        }
+        if (best > deviation) {
+            deviation = best;
+            worst = i;
+        }
+    }
+    return deviation;
+}
+
+//button state changes, the time and the new buttons
+static std::vector<Report> buttonChanges(const std::vector<Report> &reports) {
+    std::vector<Report> changes;
+    unsigned char buttons = 0;
+    for (size_t i = 0; i < reports.size(); i++) {
+        if (isReport(reports[i]) && reports[i].bytes[3] != buttons) {
+            buttons = reports[i].bytes[3];
+            changes.push_back(reports[i]);
+        }
+    }
+    return changes;
+}
+
+static void printPoint(const char *what, const PathPoint &p) {
+    printf("      %-7s %8llu us  x=%lld y=%lld wheel=%lld pan=%lld\n",
+           what, p.us, p.v[0], p.v[1], p.v[2], p.v[3]);
+}
+
+//compares a run against its golden stream, prints what differs
+//returns true if it is within tolerance
+static bool compareTolerant(const std::vector<Report> &golden, const std::vector<Report> &got) {
+    bool ok = true;
+    printf("    %u reports, golden %u\n", (unsigned int)got.size(), (unsigned int)golden.size());
+
+    std::vector<PathPoint> goldenPath = cumulativePath(golden);
+    std::vector<PathPoint> gotPath = cumulativePath(got);
+    size_t worstGolden, worstGot;
+    long long missing = pathDeviation(goldenPath, gotPath, worstGolden);
+    long long extra = pathDeviation(gotPath, goldenPath, worstGot);
+    bool pathOk = missing <= PATH_TOLERANCE && extra <= PATH_TOLERANCE;
+    printf("    path: %s, off by up to %lld counts (tolerance %d)\n",
+           pathOk ? "ok" : "FAIL", std::max(missing, extra), PATH_TOLERANCE);
+    if (missing > 0) {
+        printPoint("golden", goldenPath[worstGolden]);
+    }
+    if (extra > 0) {
+        printPoint("got", gotPath[worstGot]);
+    }
+
+    PathPoint zero;
+    memset(&zero, 0, sizeof(zero));
+    const PathPoint &goldenEnd = goldenPath.empty() ? zero : goldenPath.back();
+    const PathPoint &gotEnd = gotPath.empty() ? zero : gotPath.back();
+    long long endOff = distance(goldenEnd, gotEnd);
+    bool endOk = endOff <= PATH_TOLERANCE;
+    printf("    end: %s, off by %lld counts\n", endOk ? "ok" : "FAIL", endOff);
+    if (endOff > 0) {
+        printPoint("golden", goldenEnd);
+        printPoint("got", gotEnd);
+    }
+    ok = ok && pathOk && endOk;
+
+    std::vector<Report> goldenClicks = buttonChanges(golden);
+    std::vector<Report> gotClicks = buttonChanges(got);
+    bool clicksOk = goldenClicks.size() == gotClicks.size();
+    size_t n = std::max(goldenClicks.size(), gotClicks.size());
+    for (size_t i = 0; i < n; i++) {
+        if (i < goldenClicks.size() && i < gotClicks.size()) {
+            unsigned long long g = goldenClicks[i].doneUs, a = gotClicks[i].doneUs;
+            unsigned long long off = g > a ? g - a : a - g;
+            bool same = goldenClicks[i].bytes[3] == gotClicks[i].bytes[3] && off <= TIME_TOLERANCE_US;
+            clicksOk = clicksOk && same;
+            if (!same || off > 0) {
+                printf("      buttons %02X at %llu us, golden %02X at %llu us%s\n",
+                       gotClicks[i].bytes[3], a, goldenClicks[i].bytes[3], g, same ? "" : "  <--");
+            }
+        } else if (i < goldenClicks.size()) {
+            printf("      missing buttons %02X at %llu us  <--\n", goldenClicks[i].bytes[3], goldenClicks[i].doneUs);
+        } else {
+            printf("      extra buttons %02X at %llu us  <--\n", gotClicks[i].bytes[3], gotClicks[i].doneUs);
+        }
+    }
+    printf("    clicks: %s, %u button changes, golden %u\n", clicksOk ? "ok" : "FAIL",
+           (unsigned int)gotClicks.size(), (unsigned int)goldenClicks.size());
+
+    return ok && clicksOk;
+}
+
+
+//******************************************************************
+
+static std::vector<std::string> listTraces(void) {
+    std::vector<std::string> traces;
+    DIR *dir = opendir(TRACE_DIR);
+    if (!dir) {
+        return traces;
+    }
+    struct dirent *e;
+    while ((e = readdir(dir)) != NULL) {
+        if (e->d_name[0] != '.') {
+            traces.push_back(e->d_name);
+        }
+    }
+    closedir(dir);
+    std::sort(traces.begin(), traces.end());
+    return traces;
+}
+
+
+int main(int argc, char **argv) {
+    bool update = argc > 1 && strcmp(argv[1], "--update") == 0;
+
+    std::vector<std::string> traces = listTraces();
+    if (traces.empty()) {
+        printf("FAIL no traces in %s\n", TRACE_DIR);
+        return 1;
+    }
+
+    RunResult reference = runTimed("");
+    unsigned long long referenceNs = nsPerFrame(reference);
+    if (!reference.ok || referenceNs == 0) {
+        printf("FAIL the timing reference could not be run\n");
+        return 1;
+    }
+    printf("%-24s %d synthetic flick frames, %llu ns/frame\n", "reference", reference.frames, referenceNs);
+
+    int failures = 0;
+    for (size_t t = 0; t < traces.size(); t++) {
+        const std::string &trace = traces[t];
+        std::string path = std::string(TRACE_DIR) + "/" + trace;
+
+        //the first run is the one compared, the rest only time
+        RunResult run = runTimed(path);
+        if (!run.ok) {
+            printf("FAIL %s: could not be run\n", trace.c_str());
+            failures++;
+            continue;
+        }
+        unsigned int costPercent = (unsigned int)(nsPerFrame(run) * 100 / referenceNs);
+
+        if (update) {
+            if (!writeGolden(trace, run, costPercent)) {
+                printf("FAIL %s: can't write %s\n", trace.c_str(), goldenPath(trace).c_str());
+                failures++;
+                continue;
+            }
+            printf("%-24s updated, %u reports, %u%% of the reference per frame\n", trace.c_str(),
+                   (unsigned int)run.reports.size(), costPercent);
+            continue;
+        }
+
+        Golden golden = readGolden(trace);
+        if (!golden.ok) {
+            printf("FAIL %s: no %s, run make -f Makefile.host golden\n", trace.c_str(), goldenPath(trace).c_str());
+            failures++;
+            continue;
+        }
+
+        bool exact = sameReports(golden.reports, run.reports);
+        bool ok = exact;
+        printf("%-24s %s, %d frames, %llu ns/frame, %u%% of the reference (golden %u%%)", trace.c_str(),
+               exact ? "exact" : "differs", run.frames, nsPerFrame(run), costPercent, golden.costPercent);
+        if (golden.costPercent && costPercent > golden.costPercent * SLOW_FACTOR) {
+            printf("  SLOW");
+        }
+        printf("\n");
+        if (!exact) {
+            ok = compareTolerant(golden.reports, run.reports);
+            printf("    %s\n", ok ? "within tolerance" : "FAIL");
+        }
+        if (!ok) {
+            failures++;
+        }
+    }
+
+    if (update) {
+        return failures ? 1 : 0;
+    }
+    printf("%s\n", failures ? "FAIL" : "PASS");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,182 @@
+#include <pthread.h>
+#include <sched.h>
+#include "mbed.h"
+#include "motion_channel.h"
+
+//******************************************************************
+// Host test: the motion channel never loses motion
+//******************************************************************
+//
+// usage: test_motion_channel
+//
+// two parts:
+//  - random interleavings: one thread, a seeded random choice before
+//    every step of posting, flushing or taking, so the channel runs
+//    full, stalls and drains in every order
+//  - threads: a producer and a consumer thread hammering the channel
+//    at the same time
+// both check that what was taken adds up to exactly what was posted.
+// exits non-zero on failure.
+
+static int failures = 0;
+
+static void check(bool ok, const char *what, long long got, long long want) {
+    if (!ok) {
+        printf("FAIL %s: got %lld, want %lld\n", what, got, want);
+        failures++;
+    }
+}
+
+struct Totals {
+    long long dx, dy, wheel, pan, taps;
+    long long events;
+};
+
+static void add(Totals &t, const MotionEvent &e) {
+    t.dx += e.dx;
+    t.dy += e.dy;
+    t.wheel += e.wheel;
+    t.pan += e.pan;
+    t.taps += e.taps;
+    t.events++;
+}
+
+static void compare(const char *part, const Totals &got, const Totals &want) {
+    check(got.dx == want.dx, part, got.dx, want.dx);
+    check(got.dy == want.dy, part, got.dy, want.dy);
+    check(got.wheel == want.wheel, part, got.wheel, want.wheel);
+    check(got.pan == want.pan, part, got.pan, want.pan);
+    check(got.taps == want.taps, part, got.taps, want.taps);
+}
+
+
+//xorshift, each thread gets its own state
+static unsigned int nextRandom(unsigned int &s) {
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    return s;
+}
+
+static MotionEvent randomMotion(unsigned int &s) {
+    MotionEvent e;
+    e.dx = (int)(nextRandom(s) % 20001) - 10000;
+    e.dy = (int)(nextRandom(s) % 20001) - 10000;
+    e.wheel = (short)(nextRandom(s) % 5) - 2;
+    e.pan = (short)(nextRandom(s) % 5) - 2;
+    e.taps = (nextRandom(s) % 50 == 0) ? 1 : 0;
+    e.stampUs = nextRandom(s);
+    return e;
+}
+
+
+static void randomInterleavings(void) {
+    resetMotionChannel();
+    Totals posted = {0, 0, 0, 0, 0, 0};
+    Totals taken = {0, 0, 0, 0, 0, 0};
+    unsigned int s = 0x1234567;
+    const int STEPS = 200000;
+
+    for (int i = 0; i < STEPS; i++) {
+        unsigned int r = nextRandom(s) % 100;
+        MotionEvent e;
+        if (r < 45) {
+            e = randomMotion(s);
+            add(posted, e);
+            motionPost(e);
+        } else if (r < 55) {
+            motionFlush();
+        } else if (r < 90) {
+            if (motionTake(e)) {
+                add(taken, e);
+            }
+        } else {
+            //consumer drains everything, like a mouse tick
+            while (motionTake(e)) {
+                add(taken, e);
+            }
+        }
+    }
+
+    //producer hands over what it still holds
+    MotionEvent e;
+    while (!motionFlush()) {
+        while (motionTake(e)) {
+            add(taken, e);
+        }
+    }
+    while (motionTake(e)) {
+        add(taken, e);
+    }
+
+    compare("interleavings", taken, posted);
+    check(motionChannelStalls > 0, "interleavings ran the channel full", motionChannelStalls, 1);
+    printf("interleavings: %lld posted, %lld taken, %u stalls\n",
+           posted.events, taken.events, motionChannelStalls);
+}
+
+
+//******************************************************************
+
+#define THREAD_EVENTS 2000000
+
+static Totals threadPosted;
+static Totals threadTaken;
+static volatile bool producerDone = false;
+
+static void *producer(void *arg) {
+    unsigned int s = 0xBEEF;
+    for (int i = 0; i < THREAD_EVENTS; i++) {
+        MotionEvent e = randomMotion(s);
+        add(threadPosted, e);
+        motionPost(e);
+        //on a single core host give the consumer a chance now and then
+        if ((i & 63) == 0) {
+            sched_yield();
+        }
+    }
+    while (!motionFlush()) {
+    }
+    __sync_synchronize();
+    producerDone = true;
+    return NULL;
+}
+
+static void *consumer(void *arg) {
+    MotionEvent e;
+    while (true) {
+        bool done = producerDone;
+        __sync_synchronize();
+        bool any = false;
+        while (motionTake(e)) {
+            add(threadTaken, e);
+            any = true;
+        }
+        if (done && !any) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+static void threads(void) {
+    resetMotionChannel();
+    pthread_t p, c;
+    pthread_create(&c, NULL, consumer, NULL);
+    pthread_create(&p, NULL, producer, NULL);
+    pthread_join(p, NULL);
+    pthread_join(c, NULL);
+
+    compare("threads", threadTaken, threadPosted);
+    printf("threads: %lld posted, %lld taken, %u stalls\n",
+           threadPosted.events, threadTaken.events, motionChannelStalls);
+}
+
+
+int main(void) {
+    randomInterleavings();
+    threads();
+
+    printf("%s\n", failures ? "FAIL" : "PASS");
+    return failures ? 1 : 0;
+}
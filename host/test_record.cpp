@@ -0,0 +1,189 @@
+#include "mbed.h"
+#include "ghost_mouse.h"
+#include "sim_run.h"
+#include "sim_camera.h"
+#include "recorder.h"
+#include "scheduler.h"
+
+#include <unistd.h>
+#include <sys/wait.h>
+#include <vector>
+
+//******************************************************************
+// Host test: record and replay
+//******************************************************************
+//
+// usage: test_record
+//
+// runs TEST_TRACE through the pipeline while the recorder writes every
+// frame to a scratch file (recorder.h, as a RECORD=1 board would),
+// then replays that file through a fresh pipeline and checks that
+//  - every frame was recorded, none dropped, and the replay loads one
+//    session of them at the recorded sample period
+//  - the replay sends the same keyOut bytes at the same times
+// the trace is longer than one recorder buffer, so the chunked writes
+// of a full buffer and the final partial one are both exercised.
+// exits non-zero on failure.
+
+#define TEST_TRACE "host/traces/drag_and_tap.txt"
+
+static int failures = 0;
+
+static void check(bool ok, const char *what, long long got, long long want) {
+    if (!ok) {
+        printf("FAIL %s: got %lld, want %lld\n", what, got, want);
+        failures++;
+    }
+}
+
+struct RunResult {
+    bool ok;
+    int frames;             //frames loaded
+    int recorded;           //frames recorded, -1 when not recording
+    int dropped;
+    int sessions;           //of the input, if it was a recording
+    int periodUs;
+    std::vector<unsigned char> tx;
+    std::vector<uint64_t> doneUs;
+};
+
+static bool writeAll(int fd, const void *data, size_t len) {
+    const char *p = (const char *)data;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        len -= n;
+    }
+    return true;
+}
+
+static bool readAll(int fd, void *data, size_t len) {
+    char *p = (char *)data;
+    while (len > 0) {
+        ssize_t n = read(fd, p, len);
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        len -= n;
+    }
+    return true;
+}
+
+//runs input through the pipeline in a fresh process (the pipeline
+//lives in globals), recording to recordPath unless it is NULL
+static RunResult run(const char *input, const char *recordPath) {
+    RunResult result;
+    result.ok = false;
+    int counts[5] = {0};
+
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return result;
+    }
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return result;
+    }
+
+    if (pid == 0) {
+        close(fds[0]);
+        counts[0] = simLoadInput(input);
+        if (counts[0] < 0) {
+            _exit(1);
+        }
+        counts[3] = simRecordingSessions;
+        counts[4] = simRecordingPeriodUs;
+        ghostMouseSetup();
+        if (recordPath) {
+            recorderPath = recordPath;
+            if (!recorderStart(schedSamplePeriodUs)) {
+                _exit(1);
+            }
+        }
+        simRunPipeline();
+        counts[1] = -1;
+        if (recordPath) {
+            recorderStop();
+            counts[1] = recorderFrames;
+            counts[2] = recorderDropped;
+        }
+
+        unsigned int bytes = keyOut.simTx.size();
+        bool sent = writeAll(fds[1], counts, sizeof(counts))
+            && writeAll(fds[1], &bytes, sizeof(bytes));
+        if (sent && bytes > 0) {
+            sent = writeAll(fds[1], &keyOut.simTx[0], bytes)
+                && writeAll(fds[1], &keyOut.simTxDoneUs[0], bytes * sizeof(uint64_t));
+        }
+        _exit(sent ? 0 : 1);
+    }
+
+    close(fds[1]);
+    unsigned int bytes = 0;
+    bool ok = readAll(fds[0], counts, sizeof(counts)) && readAll(fds[0], &bytes, sizeof(bytes));
+    result.tx.resize(bytes);
+    result.doneUs.resize(bytes);
+    if (ok && bytes > 0) {
+        ok = readAll(fds[0], &result.tx[0], bytes)
+            && readAll(fds[0], &result.doneUs[0], bytes * sizeof(uint64_t));
+    }
+    close(fds[0]);
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    result.ok = ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    result.frames = counts[0];
+    result.recorded = counts[1];
+    result.dropped = counts[2];
+    result.sessions = counts[3];
+    result.periodUs = counts[4];
+    return result;
+}
+
+
+int main(void) {
+    char path[] = "/tmp/test_record_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        printf("FAIL can't make a scratch file\n");
+        return 1;
+    }
+    close(fd);
+
+    RunResult live = run(TEST_TRACE, path);
+    RunResult replay = run(path, NULL);
+    unlink(path);
+
+    if (!live.ok || !replay.ok) {
+        printf("FAIL %s could not be %s\n", TEST_TRACE, live.ok ? "replayed" : "recorded");
+        return 1;
+    }
+
+    //the camera keeps being read after the trace ran out, those frames
+    //are recorded too
+    check(live.recorded >= live.frames, "frames recorded", live.recorded, live.frames);
+    check(live.recorded > RECORDER_BUFFER_FRAMES, "frames recorded, more than a buffer",
+          live.recorded, RECORDER_BUFFER_FRAMES + 1);
+    check(live.dropped == 0, "frames dropped", live.dropped, 0);
+    check(replay.frames == live.recorded, "frames replayed", replay.frames, live.recorded);
+    check(replay.sessions == 1, "sessions", replay.sessions, 1);
+    check(replay.periodUs == SCHED_SAMPLE_PERIOD_US, "sample period", replay.periodUs, SCHED_SAMPLE_PERIOD_US);
+
+    check(!live.tx.empty(), "keyOut bytes", live.tx.size(), 1);
+    check(replay.tx == live.tx, "keyOut bytes of the replay", replay.tx.size(), live.tx.size());
+    check(replay.doneUs == live.doneUs, "keyOut times of the replay",
+          replay.doneUs.empty() ? 0 : replay.doneUs.back(), live.doneUs.empty() ? 0 : live.doneUs.back());
+
+    if (failures) {
+        return 1;
+    }
+    printf("PASS: %d frames recorded, %u keyOut bytes replayed\n", live.recorded, (unsigned int)live.tx.size());
+    return 0;
+}
@@ -0,0 +1,237 @@
+#include "mbed.h"
+#include "ghost_mouse.h"
+#include "hid_tx.h"
+#include "accel.h"
+
+//******************************************************************
+// Host test: large deltas are split, never wrapped, never lost
+//******************************************************************
+//
+// usage: test_report_split
+//
+// pushes a run of motion (flicks well past +-127 included) and taps
+// through sendMouseReports() one tick at a time, carrying what a tick
+// could not send into the next one like updateMouseState() does, and
+// checks on the bytes that left keyOut that
+//  - every field is within +-127 and has the sign of the motion
+//  - the emitted deltas add up to exactly the motion put in
+//  - every tap went out as a press and a release
+// once at the real report period, where the TX queue never fills, and
+// once with ticks too short for the RN-42 link to keep up, where the
+// queue refuses reports and nothing may be lost on the way.
+// then sends a +-FLICK_COUNTS flick, past the end of the accel tables,
+// through accelCurve() and the split for every curve, and checks that
+// the reports add up to the last table segment carried on that far
+// (capped at ACCEL_OUT_MAX), mult * FLICK_COUNTS for the straight ones.
+// exits non-zero on failure.
+
+#define REPORT_SIZE 9
+#define TICK_US 50000
+
+//about two reports fit in the link per tick (9600 baud, 9.4 ms per
+//report), flicks need more
+#define BUSY_TICK_US 20000
+
+#define FLICK_COUNTS 1000
+
+//one count in accelCurve() fixed point, MOTION_ONE in ghost_mouse.cpp
+#define COUNT_ONE (1 << ACCEL_FRAC_BITS)
+
+//button states waiting to be sent, ghost_mouse.cpp
+extern int buttonQueueLength;
+
+static int failures = 0;
+
+static void check(bool ok, const char *what, long long got, long long want) {
+    if (!ok) {
+        printf("FAIL %s: got %lld, want %lld\n", what, got, want);
+        failures++;
+    }
+}
+
+
+//deterministic pseudo random deltas, flicks included
+static unsigned int seed = 12345;
+static int nextDelta(void) {
+    seed = seed * 1103515245 + 12345;
+    int r = (seed >> 8) & 0xFFFF;
+    switch (r & 3) {
+        case 0:  return (r >> 2) % 7 - 3;        //slow
+        case 1:  return (r >> 2) % 201 - 100;    //normal
+        default: return (r >> 2) % 2001 - 1000; //flick
+    }
+}
+
+
+//ticks ticks of motion with a tap every tapEvery ticks, then
+//ticks until everything is out
+static void runTicks(const char *name, int ticks, int tickUs, int tapEvery, bool wantOverflows) {
+    keyOut.simTx.clear();
+    keyOut.simTxDoneUs.clear();
+    hidTxOverflows = 0;
+
+    long long wantX = 0, wantY = 0, wantWheel = 0, wantPan = 0;
+    short carryX = 0, carryY = 0, carryWheel = 0, carryPan = 0;
+    int wantTaps = 0;
+
+    for (int t = 0; t < ticks; t++) {
+        int dx = nextDelta(), dy = nextDelta();
+        int dw = nextDelta() / 8, dp = nextDelta() / 8;
+        wantX += dx;
+        wantY += dy;
+        wantWheel += dw;
+        wantPan += dp;
+        carryX += dx;
+        carryY += dy;
+        carryWheel += dw;
+        carryPan += dp;
+
+        //press and release in the same tick
+        if (t % tapEvery == 0) {
+            queueButtons(0x01);
+            queueButtons(0x00);
+            wantTaps++;
+        }
+
+        sendMouseReports(carryX, carryY, carryWheel, carryPan);
+        simAdvance(tickUs);
+    }
+
+    //let the carry and the button queue drain
+    for (int t = 0; t < 100000; t++) {
+        if (carryX == 0 && carryY == 0 && carryWheel == 0 && carryPan == 0
+            && buttonQueueLength == 0) {
+            break;
+        }
+        sendMouseReports(carryX, carryY, carryWheel, carryPan);
+        simAdvance(tickUs);
+    }
+    while (hidTxDepth() > 0) {
+        simAdvance(tickUs);
+    }
+    simAdvance(TICK_US);
+
+    check(carryX == 0 && carryY == 0 && carryWheel == 0 && carryPan == 0,
+          "carry drained", carryX | carryY | carryWheel | carryPan, 0);
+    check(buttonQueueLength == 0, "button queue drained", buttonQueueLength, 0);
+    if (wantOverflows) {
+        check(hidTxOverflows > 0, "hid queue overflows", hidTxOverflows, 1);
+    } else {
+        check(hidTxOverflows == 0, "hid queue overflows", hidTxOverflows, 0);
+    }
+
+    //add up what went out
+    const std::vector<unsigned char> &tx = keyOut.simTx;
+    long long gotX = 0, gotY = 0, gotWheel = 0, gotPan = 0;
+    int reports = 0, presses = 0, releases = 0;
+    unsigned char buttons = 0;
+    for (size_t i = 0; i + REPORT_SIZE <= tx.size(); i += REPORT_SIZE) {
+        check(tx[i] == 0xFD && tx[i + 1] == 0x00 && tx[i + 2] == 0x03, "report header", tx[i], 0xFD);
+        for (int f = 4; f <= 7; f++) {
+            int v = (signed char)tx[i + f];
+            check(v >= -127 && v <= 127, "field in range", v, 127);
+        }
+        gotX += (signed char)tx[i + 4];
+        gotY += (signed char)tx[i + 5];
+        gotWheel += (signed char)tx[i + 6];
+        gotPan += (signed char)tx[i + 7];
+
+        if (tx[i + 3] != buttons) {
+            if (tx[i + 3]) {
+                presses++;
+            } else {
+                releases++;
+            }
+            buttons = tx[i + 3];
+        }
+        reports++;
+    }
+    check(tx.size() % REPORT_SIZE == 0, "whole reports", tx.size() % REPORT_SIZE, 0);
+
+    check(gotX == wantX, "sum dx", gotX, wantX);
+    check(gotY == wantY, "sum dy", gotY, wantY);
+    check(gotWheel == wantWheel, "sum wheel", gotWheel, wantWheel);
+    check(gotPan == wantPan, "sum pan", gotPan, wantPan);
+    check(presses == wantTaps, "every tap pressed", presses, wantTaps);
+    check(presses == releases, "every press released", releases, presses);
+    check(buttons == 0, "buttons up at the end", buttons, 0);
+
+    printf("%s: %d reports, dx %lld dy %lld wheel %lld pan %lld, %d taps, %u refused\n",
+           name, reports, gotX, gotY, gotWheel, gotPan, presses, hidTxOverflows);
+}
+
+
+//one tick with a flick of counts in x and -counts in y through the
+//curve in use, then ticks until it is all out
+//returns the x counts that went out, y has to be the same negated
+static long long sendFlick(int counts) {
+    keyOut.simTx.clear();
+    keyOut.simTxDoneUs.clear();
+
+    short x = accelCurve(counts * COUNT_ONE) / COUNT_ONE;
+    short y = accelCurve(-counts * COUNT_ONE) / COUNT_ONE;
+    short wheel = 0, pan = 0;
+    for (int t = 0; t < 100000 && (x != 0 || y != 0); t++) {
+        sendMouseReports(x, y, wheel, pan);
+        simAdvance(TICK_US);
+    }
+    while (hidTxDepth() > 0) {
+        simAdvance(TICK_US);
+    }
+
+    const std::vector<unsigned char> &tx = keyOut.simTx;
+    long long gotX = 0, gotY = 0;
+    for (size_t i = 0; i + REPORT_SIZE <= tx.size(); i += REPORT_SIZE) {
+        gotX += (signed char)tx[i + 4];
+        gotY += (signed char)tx[i + 5];
+    }
+    check(gotY == -gotX, "flick dy", gotY, -gotX);
+    return gotX;
+}
+
+static void runFlicks(void) {
+    for (int c = 0; c < ACCEL_CURVE_COUNT; c++) {
+        mouseAccelCurveIndex = c;
+        accelCurveChanged();
+
+        const int *table = accelCurves[c];
+        long long last = table[ACCEL_TABLE_SIZE - 1];
+        long long slope = last - table[ACCEL_TABLE_SIZE - 2];
+        long long want = last + slope * (FLICK_COUNTS - (ACCEL_TABLE_SIZE - 1));
+        bool capped = want > ACCEL_OUT_MAX;
+        if (capped) {
+            want = ACCEL_OUT_MAX;
+        }
+        want /= COUNT_ONE;
+
+        long long got = sendFlick(FLICK_COUNTS);
+        check(got == want, "flick dx", got, want);
+        if (!capped) {
+            check(got > last / COUNT_ONE, "flick past the table end", got, last / COUNT_ONE + 1);
+        }
+        printf("flick %d counts, curve %d: %lld counts\n", FLICK_COUNTS, c, got);
+    }
+
+    //the straight curves, mult 1 and 3 (accel_table.h)
+    mouseAccelCurveIndex = 0;
+    accelCurveChanged();
+    long long got = sendFlick(FLICK_COUNTS);
+    check(got == FLICK_COUNTS, "flick dx, mult 1", got, FLICK_COUNTS);
+    mouseAccelCurveIndex = ACCEL_CURVE_COUNT - 1;
+    accelCurveChanged();
+    got = sendFlick(FLICK_COUNTS);
+    check(got == 3 * FLICK_COUNTS, "flick dx, mult 3", got, 3 * FLICK_COUNTS);
+}
+
+
+int main(void) {
+    hidTxInit(&keyOut);
+
+    runTicks("report period", 2000, TICK_US, 97, false);
+    //short, the carry has to stay within a short
+    runTicks("queue full", 100, BUSY_TICK_US, 7, true);
+    runFlicks();
+
+    printf("%s\n", failures ? "FAIL" : "PASS");
+    return failures ? 1 : 0;
+}
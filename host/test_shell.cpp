@@ -0,0 +1,138 @@
+#include "mbed.h"
+#include "ghost_mouse.h"
+#include "sim_run.h"
+#include "shell.h"
+#include "accel.h"
+#include "kalman.h"
+#include "gesture.h"
+#include "scheduler.h"
+#include "camera_init.h"
+#include "telemetry.h"
+
+#include <string>
+#include <vector>
+
+//******************************************************************
+// Host test: the pc shell
+//******************************************************************
+//
+// usage: test_shell
+//
+// types a session of commands into pc while a trace runs through the
+// pipeline, a line every LINE_PERIOD_US (the bytes of a line one
+// character time apart, like a terminal at 115200 baud), then checks
+//  - set changes the variable and runs its hook (camera set up again,
+//    accel table switched, new frame rate), out of range is refused,
+//    and so is a tap window with tapMinFrames not below tapMaxFrames
+//  - backspace edits the line, an over long line is dropped whole and
+//    counted, and the line after it still runs
+//  - unknown commands, parameters and arguments are answered, not run
+//  - while telemetry is on, only the line that turns it off is run,
+//    however it is spaced
+// exits non-zero on failure.
+
+//long enough for the whole session to be typed while it runs
+#define TEST_TRACE "host/traces/slow_drag.txt"
+
+//long enough for the answer to the last line to have gone out
+#define LINE_PERIOD_US 50000
+
+//camera sensitivity and lines ignored during telemetry, ghost_mouse.cpp
+extern int sen1;
+extern unsigned int pcLinesMuted;
+
+static int failures = 0;
+
+static void check(bool ok, const char *what, long long got, long long want) {
+    if (!ok) {
+        printf("FAIL %s: got %lld, want %lld\n", what, got, want);
+        failures++;
+    }
+}
+
+static std::vector<std::string> session;
+static unsigned int sessionNext = 0;
+static Ticker typist;
+
+static void typeLine(void) {
+    if (sessionNext < session.size()) {
+        const std::string &line = session[sessionNext++];
+        pc.simReceive(line.data(), line.size());
+    }
+}
+
+static void checkOutput(const std::string &out, const char *text) {
+    if (out.find(text) == std::string::npos) {
+        printf("FAIL pc output has no \"%s\"\n", text);
+        failures++;
+    }
+}
+
+
+int main(void) {
+    if (simLoadInput(TEST_TRACE) <= 0) {
+        printf("FAIL can't load %s\n", TEST_TRACE);
+        return 1;
+    }
+    ghostMouseSetup();
+    unsigned int initRuns = cameraInitRuns;
+
+    session.push_back("set tapMinFrames 12\r\n");
+    session.push_back("set tapMinFrames 5000\r\n");
+    session.push_back("set tapMaxFrames 12\n");
+    session.push_back("set tapMinFrames 50\n");
+    session.push_back("set sen1 0x80\n");
+    session.push_back("set mouseAccelCurveIndex 0\n");
+    session.push_back("set trackGatx\x7f" "e 70\n");
+    session.push_back("rate 5000x 20000\n");
+    session.push_back("rate 5000 20000\n");
+    session.push_back(std::string(SHELL_LINE_MAX + 10, 'x') + "\n");
+    session.push_back("get euroBetaQ16\n");
+    session.push_back("set nosuch 1\n");
+    session.push_back("bogus\n");
+    session.push_back("telemetry of\n");
+    session.push_back("stats\n");
+    //ignored while telemetry has the port, except turning it off
+    session.push_back("telemetry on\n");
+    session.push_back("stats\n");
+    session.push_back(" t  off \n");
+    session.push_back("get trackGate\n");
+    typist.attach_us(&typeLine, LINE_PERIOD_US);
+
+    simRunPipeline();
+
+    std::string out(pc.simTx.begin(), pc.simTx.end());
+
+    check(tapMinFrames == 12, "tapMinFrames", tapMinFrames, 12);
+    checkOutput(out, "tapMinFrames has to be 0..1000");
+    check(tapMaxFrames == TAP_MAX_FRAMES, "tapMaxFrames", tapMaxFrames, TAP_MAX_FRAMES);
+    checkOutput(out, "tapMaxFrames has to stay above tapMinFrames");
+    checkOutput(out, "tapMinFrames has to stay below tapMaxFrames");
+    check(sen1 == 0x80, "sen1", sen1, 0x80);
+    check(cameraInitRuns == initRuns + 1, "camera inits", cameraInitRuns, initRuns + 1);
+    //the tables are static, every file has its own copy, compare contents
+    check(memcmp(mouseAccelCurve, accelCurves[0], ACCEL_TABLE_SIZE * sizeof(int)) == 0,
+          "accel table", mouseAccelCurveIndex, 0);
+    check(trackGate == 70, "trackGate", trackGate, 70);
+    checkOutput(out, "usage: rate");
+    check(schedSamplePeriodUs == 5000, "sample period", schedSamplePeriodUs, 5000);
+    check(schedReportDecimation == 4, "report decimation", schedReportDecimation, 4);
+    check(trackFramePeriodUs == 5000, "track frame period", trackFramePeriodUs, 5000);
+    check(shellLinesDropped == 1, "lines dropped", shellLinesDropped, 1);
+    checkOutput(out, "euroBetaQ16");
+    checkOutput(out, "unknown parameter nosuch");
+    checkOutput(out, "unknown command bogus");
+    checkOutput(out, "usage: telemetry [on|off]");
+    check(!telemetryEnabled, "telemetry", telemetryEnabled, 0);
+    checkOutput(out, "shell: lines dropped=1 muted=0");
+    check(out.find("events:") == out.rfind("events:"), "stats answered with telemetry on", 2, 1);
+    check(pcLinesMuted == 1, "lines muted", pcLinesMuted, 1);
+    check(out.find("trackGate") != out.rfind("trackGate"), "answer after telemetry off", 1, 2);
+
+    if (failures) {
+        printf("pc output:\n%s\n", out.c_str());
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include "mbed.h"
+#include "idle.h"
+#include "event_queue.h"
+#include "scheduler.h"
+
+//sleeping ends semihosting, which recording needs
+#if defined(GHOST_RECORD) && DEVICE_SEMIHOST
+volatile bool idleSleepEnabled = false;
+#else
+volatile bool idleSleepEnabled = true;
+#endif
+volatile bool idleSemihostLost = false;
+
+//current measurement window
+//(us_ticker_read() wraps after about 71 minutes, windows have to be
+//shorter than that)
+static unsigned int windowStartUs = 0;
+static unsigned int asleepUs = 0;
+static unsigned int wakeUps = 0;
+
+
+void idleSleep(void){
+    if(!idleSleepEnabled){
+        return;
+    }
+
+    core_util_critical_section_enter();
+    if(!eventsPending()){
+        unsigned int start = us_ticker_read();
+        //straight to the HAL, sleep() is compiled out without NDEBUG
+        hal_sleep();
+#if DEVICE_SEMIHOST
+        //the LPC1768 HAL disconnects the debug interface before it sleeps
+        idleSemihostLost = true;
+#endif
+        asleepUs += us_ticker_read() - start;
+        wakeUps++;
+    }
+    core_util_critical_section_exit();
+}
+
+
+unsigned int idleDutyPermille(void){
+    unsigned int totalUs = us_ticker_read() - windowStartUs;
+    if(totalUs == 0){
+        return 0;
+    }
+    unsigned int awakeUs = totalUs - asleepUs;
+    return (unsigned int)((unsigned long long)awakeUs * 1000 / totalUs);
+}
+
+
+void idleDutyReset(void){
+    windowStartUs = us_ticker_read();
+    asleepUs = 0;
+    wakeUps = 0;
+}
+
+
+void idleDutyDump(RawSerial &out){
+    unsigned int totalUs = us_ticker_read() - windowStartUs;
+    unsigned int permille = idleDutyPermille();
+    out.printf("duty: awake %u of %u us = %u.%u%%, %u wake ups, sample period %d us\r\n",
+               totalUs - asleepUs, totalUs, permille / 10, permille % 10,
+               wakeUps, schedSamplePeriodUs);
+    idleDutyReset();
+}
@@ -0,0 +1,49 @@
+#ifndef IDLE_H
+#define IDLE_H
+
+#include "mbed.h"
+
+//******************************************************************
+// Sleeping between events and the measured duty cycle
+//******************************************************************
+//
+// all the work happens in handlers the interrupts queue up, so once
+// the event queue is empty the main loop puts the core to sleep (WFI)
+// until the next interrupt. the queue is checked with interrupts off
+// and they stay off across the WFI: an interrupt that arrives in
+// between still wakes the core (it is pending), and its handler runs
+// once they are back on, so no event is left waiting for the next one.
+//
+// only sleep, never deep sleep: on the LPC1768 deep sleep stops the
+// timers behind Ticker/Timeout, the UARTs and I2C, and only a pin
+// interrupt or the watchdog can wake it. while the frame scheduler is
+// running there is always a ticker due, so there is no wake source
+// that survives it.
+//
+// the time spent asleep is measured with us_ticker_read() around the
+// WFI, everything else counts as awake (handlers and interrupts).
+
+//set to false to keep the core spinning, e.g. for the debugger or
+//semihosting, which sleeping disconnects. it has to be false before
+//the first sleep for that: starts out false in GHOST_RECORD builds
+//(make RECORD=1) on targets with semihosting, true otherwise
+extern volatile bool idleSleepEnabled;
+
+//true once the core has slept on a target with semihosting, the
+//LocalFileSystem can't be used from then on
+extern volatile bool idleSemihostLost;
+
+//sleeps until the next interrupt unless an event is already waiting
+void idleSleep(void);
+
+//awake time in the current window, in 1/1000 of the window
+unsigned int idleDutyPermille(void);
+
+//starts a new measurement window
+void idleDutyReset(void);
+
+//prints awake/total time, duty cycle and the number of wake ups,
+//then starts a new window
+void idleDutyDump(RawSerial &out);
+
+#endif
@@ -0,0 +1,37 @@
+#include "ir_frame.h"
+#include "profiler.h"
+
+//where each point's three bytes start in the report
+//byte 0 is status, then x low, y low, then yhi:2 xhi:2 size:4
+static const unsigned char pointOffset[IR_MAX_POINTS] = {1, 4, 7, 10};
+
+
+void decodeIRFrame(const char data[CAMERA_FRAME_SIZE], IRFrame &frame){
+    PROFILE_SCOPE(PROF_DECODE);
+    unsigned char valid = 0;
+
+    //same work for every slot, no branches on the blob contents
+    for(int i = 0; i < IR_MAX_POINTS; i++){
+        const unsigned char *p = (const unsigned char *)data + pointOffset[i];
+        unsigned char s = p[2];
+        short x = p[0] | ((s & 0x30) << 4);
+        short y = p[1] | ((s & 0xC0) << 2);
+
+        frame.point[i].x = x;
+        frame.point[i].y = y;
+        frame.point[i].size = s & 0x0F;
+        valid |= (unsigned char)((x != IR_NO_POINT && y != IR_NO_POINT) << i);
+    }
+
+    frame.valid = valid;
+}
+
+
+void clearIRFrame(IRFrame &frame){
+    for(int i = 0; i < IR_MAX_POINTS; i++){
+        frame.point[i].x = IR_NO_POINT;
+        frame.point[i].y = IR_NO_POINT;
+        frame.point[i].size = 0x0F;
+    }
+    frame.valid = 0;
+}
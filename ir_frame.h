@@ -0,0 +1,40 @@
+#ifndef IR_FRAME_H
+#define IR_FRAME_H
+
+#include "camera_i2c.h"
+
+//******************************************************************
+// Decoded extended mode camera frame
+//******************************************************************
+
+#define IR_MAX_POINTS 4
+
+//coordinate the camera reports when a slot has no blob
+#define IR_NO_POINT 1023
+
+//one blob, x in 0..1023, y in 0..767, size 0..15
+struct IRPoint {
+    short x;
+    short y;
+    char size;
+};
+
+//all four blobs of one frame
+//bit i of valid is set if point[i] holds a blob
+struct IRFrame {
+    IRPoint point[IR_MAX_POINTS];
+    unsigned char valid;
+};
+
+//true if blob i was seen in the frame
+inline bool irPointValid(const IRFrame &frame, int i){
+    return (frame.valid >> i) & 1;
+}
+
+//unpacks all four (x, y, size) triples from the 16 byte report
+void decodeIRFrame(const char data[CAMERA_FRAME_SIZE], IRFrame &frame);
+
+//frame with no blobs
+void clearIRFrame(IRFrame &frame);
+
+#endif
@@ -0,0 +1,129 @@
+#include <stdlib.h>
+#include "kalman.h"
+#include "profiler.h"
+
+int trackProcessNoise = TRACK_ONE / 2;
+int trackMeasureNoise = TRACK_ONE;
+int trackGate = 60;
+
+int predictHorizonUs = 10000;
+int trackFramePeriodUs = 10000;
+
+static PointTracker trackers[IR_MAX_POINTS];
+
+
+static void axisStart(KalmanAxis &a, short z){
+    a.x = z << TRACK_FRAC_BITS;
+    a.v = 0;
+    //unknown velocity, trust the first measurement
+    a.p00 = trackMeasureNoise;
+    a.p01 = 0;
+    a.p11 = 64 * TRACK_ONE;
+}
+
+
+//predict one frame ahead
+static void axisPredict(KalmanAxis &a){
+    int q = trackProcessNoise;
+
+    //x += v, P = F P F' + Q with white noise acceleration
+    a.x += a.v;
+    a.p00 += 2 * a.p01 + a.p11 + q / 4;
+    a.p01 += a.p11 + q / 2;
+    a.p11 += q;
+}
+
+
+//innovation of a measurement against the predicted state, in counts
+static int axisInnovation(const KalmanAxis &a, short z){
+    return ((z << TRACK_FRAC_BITS) - a.x) >> TRACK_FRAC_BITS;
+}
+
+
+static void axisCorrect(KalmanAxis &a, short z){
+    int y = (z << TRACK_FRAC_BITS) - a.x;
+    int s = a.p00 + trackMeasureNoise;
+
+    //gains in Q16
+    int k0 = (int)(((long long)a.p00 << 16) / s);
+    int k1 = (int)(((long long)a.p01 << 16) / s);
+
+    a.x += (int)(((long long)k0 * y) >> 16);
+    a.v += (int)(((long long)k1 * y) >> 16);
+
+    int p00 = a.p00;
+    int p01 = a.p01;
+    a.p00 = p00 - (int)(((long long)k0 * p00) >> 16);
+    a.p01 = p01 - (int)(((long long)k0 * p01) >> 16);
+    a.p11 = a.p11 - (int)(((long long)k1 * p01) >> 16);
+}
+
+
+void trackerReset(PointTracker &t){
+    t.active = false;
+}
+
+
+bool trackerUpdate(PointTracker &t, short zx, short zy){
+    if(t.active){
+        axisPredict(t.ax);
+        axisPredict(t.ay);
+
+        //too far from where it should be, a different blob
+        if(abs(axisInnovation(t.ax, zx)) <= trackGate && abs(axisInnovation(t.ay, zy)) <= trackGate){
+            axisCorrect(t.ax, zx);
+            axisCorrect(t.ay, zy);
+            return true;
+        }
+    }
+
+    axisStart(t.ax, zx);
+    axisStart(t.ay, zy);
+    t.active = true;
+    return false;
+}
+
+
+void trackerPredict(const PointTracker &t, int horizonQ8, int &px, int &py){
+    px = t.ax.x + (int)(((long long)t.ax.v * horizonQ8) >> 8);
+    py = t.ay.x + (int)(((long long)t.ay.v * horizonQ8) >> 8);
+}
+
+
+void trackFrame(const IRFrame &raw, TrackedFrame &tracked){
+    PROFILE_SCOPE(PROF_TRACK);
+    int horizonQ8 = trackFramePeriodUs ? (predictHorizonUs << 8) / trackFramePeriodUs : 0;
+    unsigned char valid = 0;
+
+    for(int i = 0; i < IR_MAX_POINTS; i++){
+        if(!irPointValid(raw, i)){
+            trackerReset(trackers[i]);
+            tracked.x[i] = 0;
+            tracked.y[i] = 0;
+            continue;
+        }
+
+        if(trackerUpdate(trackers[i], raw.point[i].x, raw.point[i].y)){
+            valid |= 1 << i;
+        }
+        trackerPredict(trackers[i], horizonQ8, tracked.x[i], tracked.y[i]);
+    }
+
+    tracked.valid = valid;
+}
+
+
+void clearTrackedFrame(TrackedFrame &frame){
+    for(int i = 0; i < IR_MAX_POINTS; i++){
+        frame.x[i] = 0;
+        frame.y[i] = 0;
+    }
+    frame.valid = 0;
+}
+
+
+void resetTracking(void){
+    for(int i = 0; i < IR_MAX_POINTS; i++){
+        trackerReset(trackers[i]);
+    }
+}
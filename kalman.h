@@ -0,0 +1,80 @@
+#ifndef KALMAN_H
+#define KALMAN_H
+
+#include "ir_frame.h"
+
+//******************************************************************
+// Predictive constant velocity tracker per contact
+//******************************************************************
+//
+// a small Kalman filter per axis (position, velocity) in fixed point.
+// the pointer follows where the finger is predicted to be when its
+// report goes out, instead of the raw frame, which hides part of the
+// sample + transmit delay.
+//
+// measurements that land too far from the prediction (blob swaps,
+// reflections) restart the track instead of being clamped, this is
+// what used to be MOVEMENT_CAP's job.
+
+//fractional bits of positions, velocities and covariances
+#define TRACK_FRAC_BITS 8
+#define TRACK_ONE (1 << TRACK_FRAC_BITS)
+
+//tuning, in camera counts (TRACK_ONE = 1 count)
+extern int trackProcessNoise;   //velocity noise per frame, counts^2
+extern int trackMeasureNoise;   //camera noise, counts^2
+extern int trackGate;           //innovation beyond this restarts the track, counts
+
+//how far ahead of the frame to predict, and the frame period it is
+//converted with. 0 turns prediction off (filtered position only)
+extern int predictHorizonUs;
+extern int trackFramePeriodUs;
+
+struct KalmanAxis {
+    int x;      //position
+    int v;      //velocity per frame
+    int p00;    //covariance
+    int p01;
+    int p11;
+};
+
+struct PointTracker {
+    KalmanAxis ax;
+    KalmanAxis ay;
+    bool active;
+};
+
+//predicted positions of all four contacts, TRACK_FRAC_BITS fixed
+//point so motion below one camera count is not lost
+//bit i of valid is set if contact i's track carried on into this frame
+struct TrackedFrame {
+    int x[IR_MAX_POINTS];
+    int y[IR_MAX_POINTS];
+    unsigned char valid;
+};
+
+inline bool trackValid(const TrackedFrame &frame, int i){
+    return (frame.valid >> i) & 1;
+}
+
+void trackerReset(PointTracker &t);
+
+//feeds one measurement
+//returns true if the track carried on, false if it (re)started here
+bool trackerUpdate(PointTracker &t, short zx, short zy);
+
+//position horizonQ8/256 frames ahead, in TRACK_FRAC_BITS fixed point
+void trackerPredict(const PointTracker &t, int horizonQ8, int &px, int &py);
+
+//runs all four slots through their trackers
+//tracked gets the predicted positions, its valid bit is only set for
+//points whose track carried on from the previous frame, so a started
+//or restarted track never produces a delta
+void trackFrame(const IRFrame &raw, TrackedFrame &tracked);
+
+//no contacts
+void clearTrackedFrame(TrackedFrame &frame);
+
+void resetTracking(void);
+
+#endif
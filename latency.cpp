@@ -0,0 +1,69 @@
+#include "latency.h"
+
+static volatile unsigned int buckets[LATENCY_BUCKETS];
+static volatile unsigned int samples = 0;
+static volatile unsigned int maxUs = 0;
+
+
+void latencyRecord(unsigned int us){
+    unsigned int bucket = us / LATENCY_BUCKET_US;
+    if(bucket >= LATENCY_BUCKETS){
+        bucket = LATENCY_BUCKETS - 1;
+    }
+    buckets[bucket]++;
+    samples++;
+    if(us > maxUs){
+        maxUs = us;
+    }
+}
+
+
+unsigned int latencyPercentile(int percent){
+    unsigned int total = samples;
+    if(total == 0){
+        return 0;
+    }
+
+    //rank of the sample we are after, rounded up
+    unsigned int rank = (unsigned int)(((unsigned long long)total * percent + 99) / 100);
+    if(rank == 0){
+        rank = 1;
+    }
+
+    unsigned int seen = 0;
+    for(int i = 0; i < LATENCY_BUCKETS; i++){
+        seen += buckets[i];
+        if(seen >= rank){
+            return (i == LATENCY_BUCKETS - 1) ? maxUs : (i + 1) * LATENCY_BUCKET_US;
+        }
+    }
+    return maxUs;
+}
+
+
+unsigned int latencyCount(void){
+    return samples;
+}
+
+
+unsigned int latencyMax(void){
+    return maxUs;
+}
+
+
+void latencyReset(void){
+    core_util_critical_section_enter();
+    for(int i = 0; i < LATENCY_BUCKETS; i++){
+        buckets[i] = 0;
+    }
+    samples = 0;
+    maxUs = 0;
+    core_util_critical_section_exit();
+}
+
+
+void latencyDump(RawSerial &out){
+    out.printf("latency us: n=%u p50=%u p95=%u p99=%u max=%u\r\n",
+               latencyCount(), latencyPercentile(50), latencyPercentile(95),
+               latencyPercentile(99), latencyMax());
+}
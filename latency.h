@@ -0,0 +1,35 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include "mbed.h"
+
+//******************************************************************
+// End to end latency, camera frame to last report byte
+//******************************************************************
+//
+// frames are stamped with us_ticker_read() when the I2C read
+// completes, the stamp of the oldest frame that went into a report
+// travels with it through hid_tx, and the time from that stamp until
+// the report's last byte has left the keyOut UART (handed to it plus
+// one byte time) is recorded here.
+
+//histogram resolution and range, anything longer lands in the last bucket
+#define LATENCY_BUCKET_US 250
+#define LATENCY_BUCKETS 512
+
+//adds one sample, safe from interrupt context
+void latencyRecord(unsigned int us);
+
+//percentile (0..100) in us, upper edge of the bucket it falls in
+//0 if nothing has been recorded
+unsigned int latencyPercentile(int percent);
+
+unsigned int latencyCount(void);
+unsigned int latencyMax(void);
+
+void latencyReset(void);
+
+//prints count, p50/p95/p99 and max
+void latencyDump(RawSerial &out);
+
+#endif
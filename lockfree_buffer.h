@@ -0,0 +1,101 @@
+#ifndef LOCKFREE_BUFFER_H
+#define LOCKFREE_BUFFER_H
+
+#include <stdint.h>
+
+//compiler barrier, keeps the data store ahead of the index store
+//(single core Cortex-M3, no hardware reordering to worry about)
+#define LOCKFREE_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+//******************************************************************
+// Lock free variant of platform/CircularBuffer.h
+//******************************************************************
+//
+// one producer and one consumer, e.g. main code pushing and a serial
+// interrupt popping. the producer only ever writes _head and the
+// consumer only ever writes _tail, so no critical sections are needed.
+//
+// unlike CircularBuffer, push does not overwrite when full, it fails
+// and leaves the queued data alone.
+//
+// BufferSize has to be a power of two, the counters run freely and
+// are masked on access.
+template<typename T, uint32_t BufferSize>
+class LockFreeCircularBuffer {
+public:
+    LockFreeCircularBuffer() : _head(0), _tail(0) {
+    }
+
+    //producer side
+    //returns false if the buffer is full
+    bool push(const T& data) {
+        uint32_t head = _head;
+        if (head - _tail >= BufferSize) {
+            return false;
+        }
+        _pool[head & (BufferSize - 1)] = data;
+        LOCKFREE_BARRIER();
+        _head = head + 1;
+        return true;
+    }
+
+    //consumer side
+    //returns false if the buffer is empty
+    bool pop(T& data) {
+        uint32_t tail = _tail;
+        if (tail == _head) {
+            return false;
+        }
+        //the data load must not be hoisted above the _head check
+        LOCKFREE_BARRIER();
+        data = _pool[tail & (BufferSize - 1)];
+        LOCKFREE_BARRIER();
+        _tail = tail + 1;
+        return true;
+    }
+
+    //consumer side, looks at the oldest entry without taking it
+    bool peek(T& data) const {
+        uint32_t tail = _tail;
+        if (tail == _head) {
+            return false;
+        }
+        LOCKFREE_BARRIER();
+        data = _pool[tail & (BufferSize - 1)];
+        return true;
+    }
+
+    //number of queued entries, exact from either side
+    //(the other side can only make it smaller/larger respectively)
+    uint32_t size() const {
+        return _head - _tail;
+    }
+
+    uint32_t space() const {
+        return BufferSize - size();
+    }
+
+    bool empty() const {
+        return _head == _tail;
+    }
+
+    bool full() const {
+        return size() >= BufferSize;
+    }
+
+    //only safe while neither side is running
+    void reset() {
+        _head = 0;
+        _tail = 0;
+    }
+
+private:
+    //power of two check, array size goes negative otherwise
+    typedef char size_must_be_power_of_two[(BufferSize & (BufferSize - 1)) == 0 ? 1 : -1];
+
+    T _pool[BufferSize];
+    volatile uint32_t _head;
+    volatile uint32_t _tail;
+};
+
+#endif
@@ -0,0 +1,84 @@
+#include "motion_channel.h"
+#include "lockfree_buffer.h"
+
+static LockFreeCircularBuffer<MotionEvent, MOTION_CHANNEL_SIZE> channel;
+
+//producer only: an event that did not fit yet
+static MotionEvent held;
+static bool holding = false;
+
+volatile unsigned int motionChannelStalls = 0;
+volatile unsigned int motionChannelHighWater = 0;
+
+
+void clearMotion(MotionEvent &event){
+    event.dx = 0;
+    event.dy = 0;
+    event.wheel = 0;
+    event.pan = 0;
+    event.taps = 0;
+    event.stampUs = NO_STAMP;
+}
+
+
+bool motionPending(const MotionEvent &event){
+    return event.dx != 0 || event.dy != 0 || event.wheel != 0 || event.pan != 0 || event.taps != 0;
+}
+
+
+void mergeMotion(MotionEvent &into, const MotionEvent &from){
+    into.dx += from.dx;
+    into.dy += from.dy;
+    into.wheel += from.wheel;
+    into.pan += from.pan;
+    into.taps += from.taps;
+    if(into.stampUs == NO_STAMP){
+        into.stampUs = from.stampUs;
+    }
+}
+
+
+bool motionFlush(void){
+    if(!holding){
+        return true;
+    }
+    if(!channel.push(held)){
+        return false;
+    }
+    holding = false;
+
+    unsigned int depth = channel.size();
+    if(depth > motionChannelHighWater){
+        motionChannelHighWater = depth;
+    }
+    return true;
+}
+
+
+bool motionPost(const MotionEvent &event){
+    if(holding){
+        mergeMotion(held, event);
+    } else {
+        held = event;
+        holding = true;
+    }
+
+    if(!motionFlush()){
+        motionChannelStalls++;
+        return false;
+    }
+    return true;
+}
+
+
+bool motionTake(MotionEvent &event){
+    return channel.pop(event);
+}
+
+
+void resetMotionChannel(void){
+    channel.reset();
+    holding = false;
+    motionChannelStalls = 0;
+    motionChannelHighWater = 0;
+}
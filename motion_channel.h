@@ -0,0 +1,62 @@
+#ifndef MOTION_CHANNEL_H
+#define MOTION_CHANNEL_H
+
+//******************************************************************
+// Motion channel from frame processing to the report tick
+//******************************************************************
+//
+// readCameraData() (producer) posts what each frame added up to and
+// updateMouseState() (consumer) takes everything that arrived since
+// the last tick. the two sides only share a LockFreeCircularBuffer,
+// so no critical sections and no read-modify-write on shared
+// accumulators, whichever context either side runs in.
+//
+// nothing is dropped when the channel is full: the producer keeps the
+// event, merges the following ones into it and hands it over once
+// there is room again.
+
+#include "stamp.h"
+
+//queued events, has to be a power of two
+#define MOTION_CHANNEL_SIZE 16
+
+//what one or more frames added up to
+struct MotionEvent {
+    int dx;                 //pointer motion, MOTION_ONE units
+    int dy;
+    short wheel;            //whole scroll ticks
+    short pan;
+    unsigned short taps;    //left clicks
+    unsigned int stampUs;   //frame time of the oldest motion in here,
+                            //NO_STAMP without motion
+};
+
+//an event with nothing in it
+void clearMotion(MotionEvent &event);
+
+//true if the event carries anything to report
+bool motionPending(const MotionEvent &event);
+
+//adds from onto into, into keeps its (older) stamp
+void mergeMotion(MotionEvent &into, const MotionEvent &from);
+
+//producer side
+//returns false if the channel was full, the event is then held and
+//goes out with the next motionPost()/motionFlush()
+bool motionPost(const MotionEvent &event);
+
+//producer side, hands over a held event if there is room now
+//returns true if nothing is held anymore
+bool motionFlush(void);
+
+//consumer side
+//returns false if nothing is waiting
+bool motionTake(MotionEvent &event);
+
+//only while neither side is running
+void resetMotionChannel(void);
+
+extern volatile unsigned int motionChannelStalls;     //posts that found the channel full
+extern volatile unsigned int motionChannelHighWater;
+
+#endif
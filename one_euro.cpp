@@ -0,0 +1,75 @@
+#include "one_euro.h"
+#include "profiler.h"
+
+//1 Hz at rest, 0.02 Hz per count/s (a 1000 counts/s flick is filtered
+//at 21 Hz), 1 Hz on the speed estimate
+int euroMinCutoffQ8 = 1 << 8;
+int euroBetaQ16 = 1311;
+int euroDCutoffQ8 = 1 << 8;
+
+//2*pi*Te in Q16 and 1/Te, for the default 10 ms frames
+static int twoPiTeQ16 = 4118;
+static int framesPerSecond = 100;
+
+static OneEuroAxis filters[IR_MAX_POINTS][2];
+
+
+//smoothing factor of a low-pass at cutoffQ8 Hz, Q16
+//alpha = r / (r + 1) with r = 2*pi*fc*Te
+static int alphaQ16(int cutoffQ8){
+    int r = (int)(((long long)cutoffQ8 * twoPiTeQ16) >> 8);
+    return (int)(((long long)r << 16) / (r + (1 << 16)));
+}
+
+
+static int lowPass(int prev, int x, int alphaQ16){
+    return prev + (int)(((long long)(x - prev) * alphaQ16) >> 16);
+}
+
+
+void euroSetPeriod(int framePeriodUs){
+    //2*pi in Q16 is 411775
+    twoPiTeQ16 = (int)((411775LL * framePeriodUs) / 1000000);
+    framesPerSecond = 1000000 / framePeriodUs;
+}
+
+
+void euroReset(OneEuroAxis &f, int x){
+    f.x = x;
+    f.dx = 0;
+}
+
+
+int euroFilter(OneEuroAxis &f, int x){
+    //speed in whole counts/s, smoothed on its own cutoff
+    int speed = ((x - f.x) * framesPerSecond) >> TRACK_FRAC_BITS;
+    f.dx = lowPass(f.dx, speed, alphaQ16(euroDCutoffQ8));
+
+    int absSpeed = (f.dx < 0) ? -f.dx : f.dx;
+    int cutoffQ8 = euroMinCutoffQ8 + (int)(((long long)euroBetaQ16 * absSpeed) >> 8);
+    f.x = lowPass(f.x, x, alphaQ16(cutoffQ8));
+    return f.x;
+}
+
+
+void smoothFrame(TrackedFrame &frame){
+    PROFILE_SCOPE(PROF_SMOOTH);
+    for(int i = 0; i < IR_MAX_POINTS; i++){
+        if(trackValid(frame, i)){
+            frame.x[i] = euroFilter(filters[i][0], frame.x[i]);
+            frame.y[i] = euroFilter(filters[i][1], frame.y[i]);
+        } else {
+            //new or no contact, nothing to smooth against
+            euroReset(filters[i][0], frame.x[i]);
+            euroReset(filters[i][1], frame.y[i]);
+        }
+    }
+}
+
+
+void resetSmoothing(void){
+    for(int i = 0; i < IR_MAX_POINTS; i++){
+        euroReset(filters[i][0], 0);
+        euroReset(filters[i][1], 0);
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef ONE_EURO_H
+#define ONE_EURO_H
+
+#include "kalman.h"
+
+//******************************************************************
+// One-Euro smoothing of the tracked contacts
+//******************************************************************
+//
+// a first order low-pass per coordinate whose cutoff rises with the
+// speed of the contact: a resting finger gets minCutoff (heavy
+// smoothing, no jitter), a fast flick gets minCutoff + beta * speed
+// (almost no lag). Casiez et al., "1 Euro Filter", CHI 2012.
+//
+// fixed point throughout, two 64 bit divides per coordinate per
+// frame. timed as PROF_SMOOTH in PROFILE=1 builds.
+
+//tuning
+extern int euroMinCutoffQ8;     //cutoff at rest, Hz in Q8
+extern int euroBetaQ16;         //Hz of extra cutoff per count/s of speed, Q16
+extern int euroDCutoffQ8;       //cutoff of the speed estimate, Hz in Q8
+
+struct OneEuroAxis {
+    int x;      //filtered position, same fixed point as the input
+    int dx;     //filtered speed, counts/s
+};
+
+//sets the frame period the cutoffs are converted with
+void euroSetPeriod(int framePeriodUs);
+
+//starts the filter at x
+void euroReset(OneEuroAxis &f, int x);
+
+//filters one sample (TRACK_FRAC_BITS fixed point) and returns it
+int euroFilter(OneEuroAxis &f, int x);
+
+//smooths every contact of the frame in place
+//contacts whose track (re)started this frame start their filter there
+void smoothFrame(TrackedFrame &frame);
+
+void resetSmoothing(void);
+
+#endif
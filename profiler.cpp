@@ -0,0 +1,86 @@
+#include "profiler.h"
+
+#ifdef GHOST_PROFILE
+
+ProfileStats profileStats[PROF_STAGE_COUNT];
+volatile unsigned int profileAllocs = 0;
+
+static const char *const stageNames[PROF_STAGE_COUNT] = {
+    "readCameraData",
+    "decodeIRFrame",
+    "matchContacts",
+    "trackFrame",
+    "smoothFrame",
+    "twoFingerResponse",
+    "oneFingerResponse",
+    "updateClickState",
+    "updateMouseState",
+    "mouseCommand"
+};
+
+
+void profileInit(void){
+#ifndef HOST_BUILD
+    //DWT is part of the trace block, which is off after reset
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+
+    memset(profileStats, 0, sizeof(profileStats));
+    for(int i = 0; i < PROF_STAGE_COUNT; i++){
+        profileStats[i].min = 0xFFFFFFFF;
+    }
+}
+
+
+const char *profileStageName(ProfileStage stage){
+    return stageNames[stage];
+}
+
+
+void profileRecord(ProfileStage stage, unsigned int cycles, unsigned int allocs){
+    ProfileStats &s = profileStats[stage];
+
+    s.count++;
+    s.total += cycles;
+    s.allocs += allocs;
+    if(cycles < s.min){
+        s.min = cycles;
+    }
+    if(cycles > s.max){
+        s.max = cycles;
+    }
+
+    //bucket is the position of the highest set bit
+    int bucket = cycles ? 31 - __builtin_clz(cycles) : 0;
+    if(bucket >= PROFILE_BUCKETS){
+        bucket = PROFILE_BUCKETS - 1;
+    }
+    s.histogram[bucket]++;
+}
+
+
+void profileDump(RawSerial &out){
+    out.printf("stage               count      min      max     mean   allocs\r\n");
+    for(int i = 0; i < PROF_STAGE_COUNT; i++){
+        const ProfileStats &s = profileStats[i];
+        unsigned int mean = s.count ? (unsigned int)(s.total / s.count) : 0;
+        out.printf("%-18s %6u %8u %8u %8u %8u\r\n", stageNames[i], s.count,
+                   s.count ? s.min : 0, s.max, mean, s.allocs);
+    }
+
+    //one line per stage, only buckets that were hit
+    out.printf("histogram (2^i cycles: count)\r\n");
+    for(int i = 0; i < PROF_STAGE_COUNT; i++){
+        out.printf("%-18s", stageNames[i]);
+        for(int b = 0; b < PROFILE_BUCKETS; b++){
+            if(profileStats[i].histogram[b]){
+                out.printf(" %d:%u", b, profileStats[i].histogram[b]);
+            }
+        }
+        out.printf("\r\n");
+    }
+}
+
+#endif
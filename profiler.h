@@ -0,0 +1,98 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+//******************************************************************
+// Cycle count profiler for the pipeline stages
+//******************************************************************
+//
+// build with -DGHOST_PROFILE to enable. each PROFILE_SCOPE(stage)
+// times the rest of the enclosing block with the DWT cycle counter
+// (rdtsc on the host build) and keeps min/max/mean and a power of two
+// histogram per stage. without GHOST_PROFILE the macros are empty and
+// nothing here is compiled in.
+//
+// stages nest: readCameraData includes every stage up to
+// updateClickState, updateMouseState includes mouseCommand.
+//
+// each stage also counts the heap allocations made while it ran, from
+// profileAllocs. nothing on the board counts them (the pipeline does
+// not allocate), host/bench_pipeline.cpp hooks malloc to check that.
+
+#include "mbed.h"
+
+enum ProfileStage {
+    PROF_READ_CAMERA,
+    PROF_DECODE,
+    PROF_CONTACTS,
+    PROF_TRACK,
+    PROF_SMOOTH,
+    PROF_SCROLL,
+    PROF_ONE_FINGER,
+    PROF_CLICK_STATE,
+    PROF_MOUSE_STATE,
+    PROF_MOUSE_COMMAND,
+    PROF_STAGE_COUNT
+};
+
+//histogram bucket i counts samples of 2^i to 2^(i+1)-1 cycles,
+//the last bucket takes everything above
+#define PROFILE_BUCKETS 16
+
+struct ProfileStats {
+    unsigned int count;
+    unsigned int min;
+    unsigned int max;
+    unsigned long long total;
+    unsigned int allocs;
+    unsigned int histogram[PROFILE_BUCKETS];
+};
+
+#ifdef GHOST_PROFILE
+
+#ifdef HOST_BUILD
+#include <x86intrin.h>
+inline unsigned int profileNow(void){
+    return (unsigned int)__rdtsc();
+}
+#else
+inline unsigned int profileNow(void){
+    return DWT->CYCCNT;
+}
+#endif
+
+//starts the cycle counter and clears the stats
+void profileInit(void);
+
+void profileRecord(ProfileStage stage, unsigned int cycles, unsigned int allocs);
+
+//heap allocations so far, bumped by an allocator hook if there is one
+extern volatile unsigned int profileAllocs;
+
+//name of a stage as printed by profileDump()
+const char *profileStageName(ProfileStage stage);
+
+//prints a table of all stages
+void profileDump(RawSerial &out);
+
+extern ProfileStats profileStats[PROF_STAGE_COUNT];
+
+//times from construction to the end of the enclosing scope
+class ProfileScope {
+public:
+    ProfileScope(ProfileStage stage) : _stage(stage), _allocs(profileAllocs), _start(profileNow()) {}
+    ~ProfileScope() { profileRecord(_stage, profileNow() - _start, profileAllocs - _allocs); }
+private:
+    ProfileStage _stage;
+    unsigned int _allocs;
+    unsigned int _start;
+};
+
+#define PROFILE_SCOPE(stage) ProfileScope profileScope_(stage)
+
+#else
+
+#define PROFILE_SCOPE(stage)
+
+#endif
+
+#endif
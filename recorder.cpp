@@ -0,0 +1,182 @@
+#include "mbed.h"
+#include "recorder.h"
+#include "idle.h"
+
+const char *recorderPath = "/local/ghost.rec";
+
+unsigned int recorderFrames = 0;
+unsigned int recorderDropped = 0;
+
+#ifdef GHOST_RECORD
+
+//the magic USB drive of the mbed
+static LocalFileSystem local("local");
+
+#define RECORDER_BUFFER_SIZE (RECORDER_BUFFER_FRAMES * RECORDER_RECORD_SIZE)
+
+static FILE *recordFile = NULL;
+
+//two buffers, frames go into fill while the other one may be waiting
+//to be written
+static char buffers[2][RECORDER_BUFFER_SIZE];
+static int bufferUsed[2];
+static int bufferWritten[2];
+static bool bufferFull[2];
+static int fill = 0;
+
+//sleep setting from before the recording started
+static bool sleepWasEnabled = true;
+
+
+static void putStamp(char *p, unsigned int v){
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+    p[2] = (v >> 16) & 0xFF;
+    p[3] = (v >> 24) & 0xFF;
+}
+
+
+//writes up to max more bytes of buffer b, frees it once all are out
+static void writeBuffer(int b, int max){
+    int n = bufferUsed[b] - bufferWritten[b];
+    if(n > max){
+        n = max;
+    }
+    if(n > 0){
+        fwrite(buffers[b] + bufferWritten[b], 1, n, recordFile);
+        bufferWritten[b] += n;
+    }
+    if(bufferWritten[b] == bufferUsed[b]){
+        bufferUsed[b] = 0;
+        bufferWritten[b] = 0;
+        bufferFull[b] = false;
+    }
+}
+
+
+//the older of the buffers waiting to be written. fill is the newest
+//buffer, unless both are full: then fill was switched to the older one
+//that is still waiting
+static int oldestBuffer(void){
+    return bufferFull[fill] ? fill : 1 - fill;
+}
+
+
+bool recorderStart(int samplePeriodUs){
+    if(recordFile){
+        recorderStop();
+    }
+    //fopen would fail or hang without semihosting
+    if(idleSemihostLost){
+        return false;
+    }
+    recordFile = fopen(recorderPath, "ab");
+    if(!recordFile){
+        return false;
+    }
+
+    bufferUsed[0] = bufferUsed[1] = 0;
+    bufferWritten[0] = bufferWritten[1] = 0;
+    bufferFull[0] = bufferFull[1] = false;
+    fill = 0;
+    recorderFrames = 0;
+    recorderDropped = 0;
+
+    //session header: magic, version, frame size, sample period
+    char header[RECORDER_RECORD_SIZE];
+    memset(header, 0, sizeof(header));
+    putStamp(header, RECORDER_SESSION_MARK);
+    memcpy(header + 4, RECORDER_MAGIC, 4);
+    header[8] = RECORDER_VERSION;
+    header[9] = CAMERA_FRAME_SIZE;
+    putStamp(header + 12, samplePeriodUs);
+    fwrite(header, 1, sizeof(header), recordFile);
+
+    sleepWasEnabled = idleSleepEnabled;
+    idleSleepEnabled = false;
+    return true;
+}
+
+
+void recorderStop(void){
+    if(!recordFile){
+        return;
+    }
+    //everything that is left, in order
+    int first = oldestBuffer();
+    writeBuffer(first, RECORDER_BUFFER_SIZE);
+    writeBuffer(1 - first, RECORDER_BUFFER_SIZE);
+    fclose(recordFile);
+    recordFile = NULL;
+
+    idleSleepEnabled = sleepWasEnabled;
+}
+
+
+bool recorderActive(void){
+    return recordFile != NULL;
+}
+
+
+void recorderFrame(const char data[CAMERA_FRAME_SIZE], unsigned int stampUs){
+    if(!recordFile){
+        return;
+    }
+    if(bufferFull[fill]){
+        recorderDropped++;
+        return;
+    }
+
+    if(stampUs == RECORDER_SESSION_MARK){
+        stampUs--;
+    }
+    char *p = buffers[fill] + bufferUsed[fill];
+    putStamp(p, stampUs);
+    memcpy(p + 4, data, CAMERA_FRAME_SIZE);
+    bufferUsed[fill] += RECORDER_RECORD_SIZE;
+    recorderFrames++;
+
+    //full, hand it to recorderFlush() and carry on in the other one
+    if(bufferUsed[fill] == RECORDER_BUFFER_SIZE){
+        bufferFull[fill] = true;
+        fill = 1 - fill;
+    }
+}
+
+
+void recorderFlush(void){
+    if(!recordFile){
+        return;
+    }
+    int b = oldestBuffer();
+    if(bufferFull[b]){
+        writeBuffer(b, RECORDER_WRITE_CHUNK);
+    }
+}
+
+#else
+
+//without RECORD=1 there is nothing to record with: no LocalFileSystem,
+//no buffers
+bool recorderStart(int samplePeriodUs){
+    return false;
+}
+
+
+void recorderStop(void){
+}
+
+
+bool recorderActive(void){
+    return false;
+}
+
+
+void recorderFrame(const char data[CAMERA_FRAME_SIZE], unsigned int stampUs){
+}
+
+
+void recorderFlush(void){
+}
+
+#endif
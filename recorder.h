@@ -0,0 +1,77 @@
+#ifndef RECORDER_H
+#define RECORDER_H
+
+#include "mbed.h"
+#include "camera_i2c.h"
+
+//******************************************************************
+// Raw camera frame recorder
+//******************************************************************
+//
+// appends every frame the pipeline processes, exactly as it came off
+// the bus, to a file on the mbed's LocalFileSystem. the host build
+// replays such a file through the same pipeline code
+// (ghost_mouse_host <file.rec>), so a session on the real hardware
+// becomes a reproducible test input.
+//
+// the file is a sequence of fixed size records
+//   stamp      4 bytes, little endian, us_ticker_read() of the frame
+//   frame      CAMERA_FRAME_SIZE bytes, the raw read
+// a record with stamp RECORDER_SESSION_MARK starts a session, its 16
+// bytes hold RECORDER_MAGIC, the format version and the sample period
+// (see recorderStart()). a frame that really has that stamp is stored
+// one us earlier. every start appends a new session to the file.
+//
+// frames are copied into one of two RAM buffers; a full buffer is
+// written out by recorderFlush() from the main loop once it has run
+// out of events, so the write never sits between a frame and its
+// processing. a semihosted fwrite blocks the main loop until the host
+// has taken the data, so each pass writes at most RECORDER_WRITE_CHUNK
+// bytes and the next frame waits for one short write, not a whole
+// buffer. if both buffers are full the frame is not recorded and
+// counted in recorderDropped (its absence also shows in the stamps).
+//
+// only make RECORD=1 (GHOST_RECORD) builds have the LocalFileSystem
+// and the buffers, in other builds recorderStart() always refuses.
+// LocalFileSystem works over semihosting, which the first idle sleep
+// disconnects for good, so GHOST_RECORD also keeps idle sleep off from
+// boot; recorderStart() refuses once the core has slept anyway
+// (idleSemihostLost). idle sleep stays off while recording.
+
+#define RECORDER_SESSION_MARK 0xFFFFFFFF
+#define RECORDER_MAGIC "GHRC"
+#define RECORDER_VERSION 1
+
+#define RECORDER_RECORD_SIZE (4 + CAMERA_FRAME_SIZE)
+
+//frames per buffer, 64 is 0.64 s at 100 Hz and 1280 bytes
+#define RECORDER_BUFFER_FRAMES 64
+
+//most bytes recorderFlush() writes in one main loop pass, 8 frames.
+//the main loop passes at least once per frame, so a full buffer is
+//out well before the other one fills
+#define RECORDER_WRITE_CHUNK (8 * RECORDER_RECORD_SIZE)
+
+//file recordings are appended to, "/local/..." on the board
+extern const char *recorderPath;
+
+//opens the file and writes a session header, false if it can't be
+//opened or semihosting is already gone
+bool recorderStart(int samplePeriodUs);
+
+//writes what is buffered and closes the file
+void recorderStop(void);
+
+bool recorderActive(void);
+
+//called with every frame the pipeline takes, main loop only
+void recorderFrame(const char data[CAMERA_FRAME_SIZE], unsigned int stampUs);
+
+//writes the next RECORDER_WRITE_CHUNK bytes of a full buffer, if
+//there is one, from the main loop
+void recorderFlush(void);
+
+extern unsigned int recorderFrames;     //frames recorded this session
+extern unsigned int recorderDropped;    //frames lost to full buffers
+
+#endif
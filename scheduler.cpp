@@ -0,0 +1,85 @@
+#include "mbed.h"
+#include "scheduler.h"
+
+int schedSamplePeriodUs = SCHED_SAMPLE_PERIOD_US;
+int schedReportDecimation = SCHED_REPORT_PERIOD_US / SCHED_SAMPLE_PERIOD_US;
+int schedEmitOffsetUs = SCHED_EMIT_OFFSET_US;
+
+static Ticker frameTicker;
+static Timeout emitTimeout;
+
+static void (*captureHook)(void) = NULL;
+static void (*emitHook)(void) = NULL;
+
+//completed frames since the last emit
+static volatile int framesSinceEmit = 0;
+
+//sample ticks since a frame last completed
+static volatile int ticksSinceFrame = 0;
+
+
+//start of every frame. with no completed frame for a whole report
+//period (camera stalled, bus errors, re-init) the emit runs from here,
+//so queued taps, releases and carried motion still go out
+static void frameTick(void){
+    if(++ticksSinceFrame >= schedReportDecimation){
+        ticksSinceFrame = 0;
+        framesSinceEmit = 0;
+        if(emitHook){
+            emitHook();
+        }
+    }
+    if(captureHook){
+        captureHook();
+    }
+}
+
+
+void schedulerStart(int samplePeriodUs, int reportPeriodUs, int emitOffsetUs,
+                    void (*capture)(void), void (*emit)(void)){
+    //the sample ticker and the frame interrupt read all of this, a
+    //restart from the main loop must not be seen half done
+    core_util_critical_section_enter();
+    schedulerStop();
+
+    schedSamplePeriodUs = samplePeriodUs;
+    schedReportDecimation = (reportPeriodUs + samplePeriodUs / 2) / samplePeriodUs;
+    if(schedReportDecimation < 1){
+        schedReportDecimation = 1;
+    }
+    schedEmitOffsetUs = emitOffsetUs;
+    captureHook = capture;
+    emitHook = emit;
+    framesSinceEmit = 0;
+    ticksSinceFrame = 0;
+
+    frameTicker.attach_us(&frameTick, samplePeriodUs);
+    core_util_critical_section_exit();
+}
+
+
+void schedulerStop(void){
+    frameTicker.detach();
+    emitTimeout.detach();
+}
+
+
+void schedulerFrameDone(void){
+    ticksSinceFrame = 0;
+
+    //counted by completed frames, so a lost frame delays the report to
+    //the next good one instead of sending it without fresh data
+    if(++framesSinceEmit < schedReportDecimation){
+        return;
+    }
+    framesSinceEmit = 0;
+
+    if(!emitHook){
+        return;
+    }
+    if(schedEmitOffsetUs > 0){
+        emitTimeout.attach_us(emitHook, schedEmitOffsetUs);
+    } else {
+        emitHook();
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+//******************************************************************
+// Phase aligned frame scheduler
+//******************************************************************
+//
+// one Ticker per sample period starts the capture. when the camera
+// finishes the frame (schedulerFrameDone() from the I2C interrupt)
+// the frame gets processed, and every reportDecimation frames the emit
+// phase follows emitOffsetUs later. a report therefore always goes
+// out the same, short time after the frame it carries, instead of at
+// a random point of an unrelated 50 ms ticker.
+//
+//   tick     capture ........ frame done  process  [emit]
+//   |<------------------ samplePeriodUs ------------------>|
+//                              |<- emitOffsetUs ->|
+//
+// when no frame completes for a whole report period the emit runs
+// from the sample ticker instead, without new data, so what is already
+// queued for the host is not held back by a stalled camera.
+
+//default rates: 100 Hz sampling, 20 Hz reports, emit right after the
+//frame has been processed
+#define SCHED_SAMPLE_PERIOD_US 10000
+#define SCHED_REPORT_PERIOD_US 50000
+#define SCHED_EMIT_OFFSET_US 0
+
+//shortest sample period worth asking for, a frame read takes about
+//half a ms at 400 kHz and the pipeline has to fit in behind it
+#define SCHED_MIN_SAMPLE_PERIOD_US 2500
+
+//current configuration
+extern int schedSamplePeriodUs;
+extern int schedReportDecimation;   //frames per report, report period / sample period
+extern int schedEmitOffsetUs;
+
+//(re)starts the scheduler
+//capture runs from the ticker at the start of every frame, emit runs
+//from interrupt context emitOffsetUs after every reportDecimation'th
+//completed frame (0 runs it straight from schedulerFrameDone())
+//reportPeriodUs is rounded to a whole number of sample periods
+//safe to call while it is running, with interrupts off throughout
+void schedulerStart(int samplePeriodUs, int reportPeriodUs, int emitOffsetUs,
+                    void (*capture)(void), void (*emit)(void));
+
+void schedulerStop(void);
+
+//called from the camera interrupt when a frame is complete
+void schedulerFrameDone(void);
+
+#endif
@@ -0,0 +1,98 @@
+#include <stdlib.h>
+#include "scroll.h"
+#include "profiler.h"
+
+//sub-tick scroll carried between frames, in camera counts
+static short accumWheel = 0;
+static short accumPan = 0;
+
+static bool latched = false;
+
+
+//number of blobs in a valid mask
+static int countPoints(unsigned char valid){
+    int n = 0;
+    for(; valid; valid &= valid - 1){
+        n++;
+    }
+    return n;
+}
+
+
+//takes whole ticks out of the accumulator and leaves the remainder
+static short takeTicks(short &accum){
+    short ticks = accum / SCROLL_COUNTS_PER_TICK;
+    accum -= ticks * SCROLL_COUNTS_PER_TICK;
+    return ticks;
+}
+
+
+bool twoFingerResponse(const IRFrame &curr, const IRFrame &prev, short &wheel, short &pan){
+    PROFILE_SCOPE(PROF_SCROLL);
+    wheel = 0;
+    pan = 0;
+
+    if(curr.valid == 0){
+        //all fingers up, back to pointing
+        latched = false;
+        accumWheel = 0;
+        accumPan = 0;
+        return false;
+    }
+
+    if(countPoints(curr.valid) != 2){
+        return false;
+    }
+    latched = true;
+
+    //same two slots in both frames, otherwise there is no delta yet
+    if(curr.valid != prev.valid){
+        return true;
+    }
+
+    int a = -1;
+    int b = -1;
+    for(int i = 0; i < IR_MAX_POINTS; i++){
+        if(irPointValid(curr, i)){
+            if(a < 0){
+                a = i;
+            } else {
+                b = i;
+            }
+        }
+    }
+
+    short dax = curr.point[a].x - prev.point[a].x;
+    short day = curr.point[a].y - prev.point[a].y;
+    short dbx = curr.point[b].x - prev.point[b].x;
+    short dby = curr.point[b].y - prev.point[b].y;
+
+    //pinch/rotate, not a scroll
+    if(abs(dax - dbx) > SCROLL_SPREAD_TOLERANCE || abs(day - dby) > SCROLL_SPREAD_TOLERANCE){
+        return true;
+    }
+
+    short dx = (dax + dbx) / 2;
+    short dy = (day + dby) / 2;
+
+    //camera y runs the other way from the mouse, same as
+    //oneFingerResponse: fingers moving up scroll up
+    accumWheel += dy;
+    accumPan += dx;
+
+    wheel = takeTicks(accumWheel);
+    pan = takeTicks(accumPan);
+    return true;
+}
+
+
+bool scrollLatched(void){
+    return latched;
+}
+
+
+void resetScroll(void){
+    accumWheel = 0;
+    accumPan = 0;
+    latched = false;
+}
@@ -0,0 +1,38 @@
+#ifndef SCROLL_H
+#define SCROLL_H
+
+#include "ir_frame.h"
+
+//******************************************************************
+// Two finger scroll
+//******************************************************************
+//
+// two blobs moving together scroll instead of moving the pointer.
+// the shared motion is accumulated in 1/SCROLL_COUNTS_PER_TICK steps
+// so slow scrolling still produces whole wheel ticks eventually.
+// there is no per frame deadzone: it would throw away a slow scroll
+// of a count per frame whole. jitter goes back and forth and cancels
+// in the accumulator, only SCROLL_COUNTS_PER_TICK counts of net motion
+// make a tick.
+
+//camera counts of two finger motion per wheel tick
+const short SCROLL_COUNTS_PER_TICK = 24;
+
+//the two fingers count as moving together while their deltas differ
+//by at most this much per axis (more is a pinch or rotation)
+const short SCROLL_SPREAD_TOLERANCE = 6;
+
+//looks at the frame pair and accumulates scroll
+//returns true while two fingers are down, the frame is then taken by
+//the scroll gesture and must not move the pointer or click
+//wheel/pan get the whole ticks to send (wheel > 0 scrolls up,
+//pan > 0 scrolls right)
+bool twoFingerResponse(const IRFrame &curr, const IRFrame &prev, short &wheel, short &pan);
+
+//true from the start of a scroll until every finger has lifted, so
+//the finger left behind does not jump the pointer
+bool scrollLatched(void);
+
+void resetScroll(void);
+
+#endif
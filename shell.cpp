@@ -0,0 +1,208 @@
+#include "shell.h"
+
+volatile unsigned int shellLinesDropped = 0;
+
+static RawSerial *shellOut = NULL;
+static const ShellCommand *commandTable = NULL;
+static int commandTableLength = 0;
+static const ShellParam *paramTable = NULL;
+static int paramTableLength = 0;
+
+//line being typed, interrupt side only
+static char rxLine[SHELL_LINE_MAX];
+static int rxLength = 0;
+static bool rxOverflow = false;
+
+//finished line, written by the interrupt while lineReady is false and
+//read by the main loop while it is true
+static char readyLine[SHELL_LINE_MAX];
+static volatile bool lineReady = false;
+
+
+void shellInit(RawSerial *out, const ShellCommand *commands, int commandCount,
+               const ShellParam *params, int paramCount){
+    shellOut = out;
+    commandTable = commands;
+    commandTableLength = commandCount;
+    paramTable = params;
+    paramTableLength = paramCount;
+    rxLength = 0;
+    rxOverflow = false;
+    lineReady = false;
+}
+
+
+bool shellRx(char c){
+    if(c == '\r' || c == '\n'){
+        //CR LF ends a line once, not twice
+        if(rxLength == 0 && !rxOverflow){
+            return false;
+        }
+        bool ready = false;
+        if(rxOverflow || lineReady){
+            shellLinesDropped++;
+        } else {
+            memcpy(readyLine, rxLine, rxLength);
+            readyLine[rxLength] = '\0';
+            lineReady = true;
+            ready = true;
+        }
+        rxLength = 0;
+        rxOverflow = false;
+        return ready;
+    }
+
+    if(c == 8 || c == 127){
+        if(rxLength > 0){
+            rxLength--;
+        }
+    } else if(rxLength < SHELL_LINE_MAX - 1){
+        rxLine[rxLength++] = c;
+    } else {
+        rxOverflow = true;
+    }
+    return false;
+}
+
+
+int shellSplitWords(char *line, char **argv){
+    int argc = 0;
+    char *p = line;
+    while(*p && argc < SHELL_MAX_ARGS){
+        while(*p == ' ' || *p == '\t'){
+            p++;
+        }
+        if(!*p){
+            break;
+        }
+        argv[argc++] = p;
+        while(*p && *p != ' ' && *p != '\t'){
+            p++;
+        }
+        if(*p){
+            *p++ = '\0';
+        }
+    }
+    return argc;
+}
+
+
+static const ShellParam *findParam(const char *name){
+    for(int i = 0; i < paramTableLength; i++){
+        if(strcmp(paramTable[i].name, name) == 0){
+            return &paramTable[i];
+        }
+    }
+    return NULL;
+}
+
+
+static void printParam(const ShellParam &p){
+    shellOut->printf("%-20s %8d  (%d..%d) %s\r\n", p.name, *p.value, p.min, p.max, p.help);
+}
+
+
+static void runHelp(void){
+    for(int i = 0; i < commandTableLength; i++){
+        if(commandTable[i].help){
+            shellOut->printf("%-10s %s\r\n", commandTable[i].name, commandTable[i].help);
+        }
+    }
+    shellOut->printf("%-10s %s\r\n", "get", "[name]  print parameters");
+    shellOut->printf("%-10s %s\r\n", "set", "<name> <value>  change a parameter");
+    shellOut->printf("parameters:\r\n");
+    for(int i = 0; i < paramTableLength; i++){
+        printParam(paramTable[i]);
+    }
+}
+
+
+static void runGet(int argc, char **argv){
+    if(argc < 2){
+        for(int i = 0; i < paramTableLength; i++){
+            printParam(paramTable[i]);
+        }
+        return;
+    }
+    const ShellParam *p = findParam(argv[1]);
+    if(!p){
+        shellOut->printf("unknown parameter %s\r\n", argv[1]);
+        return;
+    }
+    printParam(*p);
+}
+
+
+static void runSet(int argc, char **argv){
+    if(argc != 3){
+        shellOut->printf("usage: set <name> <value>\r\n");
+        return;
+    }
+    const ShellParam *p = findParam(argv[1]);
+    if(!p){
+        shellOut->printf("unknown parameter %s\r\n", argv[1]);
+        return;
+    }
+    char *end;
+    long value = strtol(argv[2], &end, 0);
+    if(end == argv[2] || *end){
+        shellOut->printf("not a number: %s\r\n", argv[2]);
+        return;
+    }
+    if(value < p->min || value > p->max){
+        shellOut->printf("%s has to be %d..%d\r\n", p->name, p->min, p->max);
+        return;
+    }
+    const char *refused = p->check ? p->check((int)value) : NULL;
+    if(refused){
+        shellOut->printf("%s\r\n", refused);
+        return;
+    }
+    *p->value = (int)value;
+    if(p->changed){
+        p->changed();
+    }
+    printParam(*p);
+}
+
+
+bool shellTakeLine(char line[SHELL_LINE_MAX]){
+    if(!lineReady){
+        return false;
+    }
+    memcpy(line, readyLine, SHELL_LINE_MAX);
+    lineReady = false;
+    return true;
+}
+
+
+void shellExecute(char *line){
+    if(!shellOut){
+        return;
+    }
+    char *argv[SHELL_MAX_ARGS];
+    int argc = shellSplitWords(line, argv);
+    if(argc == 0){
+        return;
+    }
+
+    if(strcmp(argv[0], "help") == 0){
+        runHelp();
+        return;
+    }
+    if(strcmp(argv[0], "get") == 0){
+        runGet(argc, argv);
+        return;
+    }
+    if(strcmp(argv[0], "set") == 0){
+        runSet(argc, argv);
+        return;
+    }
+    for(int i = 0; i < commandTableLength; i++){
+        if(strcmp(commandTable[i].name, argv[0]) == 0){
+            commandTable[i].run(argc, argv);
+            return;
+        }
+    }
+    shellOut->printf("unknown command %s, try help\r\n", argv[0]);
+}
@@ -0,0 +1,74 @@
+#ifndef SHELL_H
+#define SHELL_H
+
+#include "mbed.h"
+
+//******************************************************************
+// Line based command shell on the pc port
+//******************************************************************
+//
+// the RX interrupt only collects characters (shellRx()). when a line
+// is complete (CR or LF) it is handed to the main loop, which splits
+// it into words and runs it (shellTakeLine(), shellExecute()), so
+// parsing and printing never happen in interrupt context. one finished
+// line waits at a time, a line that completes while the last one has
+// not been run yet is dropped and counted. backspace/DEL edit the
+// line, a line longer than SHELL_LINE_MAX - 1 characters is thrown
+// away whole.
+//
+// there is no echo: telemetry shares the port, so characters are not
+// sent back from the interrupt. turn on local echo in the terminal.
+//
+// commands and tunable parameters come from tables the caller passes
+// to shellInit(). three commands are built in:
+//   help               lists the commands and parameters
+//   get [name]         prints one parameter, or all of them
+//   set name value     changes a parameter (decimal or 0x hex),
+//                      refused outside min..max or if its check
+//                      says no
+
+#define SHELL_LINE_MAX 64
+#define SHELL_MAX_ARGS 6
+
+struct ShellCommand {
+    const char *name;
+    void (*run)(int argc, char **argv);     //argv[0] is the command name
+    const char *help;                       //arguments and what it does,
+                                            //NULL keeps it out of help
+};
+
+struct ShellParam {
+    const char *name;
+    int *value;
+    int min;
+    int max;
+    void (*changed)(void);                  //run after a set, may be NULL
+    const char *help;
+    const char *(*check)(int value);        //NULL if a value in min..max
+                                            //goes with the other
+                                            //parameters, else why not.
+                                            //may be NULL
+};
+
+//lines dropped because the last one was still waiting or was too long
+extern volatile unsigned int shellLinesDropped;
+
+void shellInit(RawSerial *out, const ShellCommand *commands, int commandCount,
+               const ShellParam *params, int paramCount);
+
+//from the RX interrupt, one character at a time
+//true when a line is waiting for shellTakeLine()
+bool shellRx(char c);
+
+//copies the waiting line, if there is one, and frees the slot for the
+//next. false if there is none
+bool shellTakeLine(char line[SHELL_LINE_MAX]);
+
+//splits line into words in place, at most SHELL_MAX_ARGS of them
+//into argv, returns how many
+int shellSplitWords(char *line, char **argv);
+
+//splits line (changed in place) into words and runs it
+void shellExecute(char *line);
+
+#endif
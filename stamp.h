@@ -0,0 +1,16 @@
+#ifndef STAMP_H
+#define STAMP_H
+
+//******************************************************************
+// Frame time stamps
+//******************************************************************
+//
+// the us_ticker_read() time of the frame behind some motion travels
+// with it from the motion channel to the RN-42 link, where the time
+// from it until the report has gone out becomes a latency sample
+// (motion_channel.h, hid_tx.h, latency.h)
+
+//no frame behind it, no latency sample
+#define NO_STAMP 0xFFFFFFFF
+
+#endif
@@ -0,0 +1,220 @@
+#include "telemetry.h"
+#include "lockfree_buffer.h"
+
+static RawSerial *telPort = NULL;
+static LockFreeCircularBuffer<unsigned char, TEL_BUFFER_SIZE> telBuffer;
+
+//true while the TX interrupt is attached and draining the buffer
+static volatile bool telActive = false;
+
+//next sequence number, only touched by the main loop
+static unsigned short telSequence = 0;
+
+volatile bool telemetryEnabled = false;
+volatile unsigned int telemetryRecords = 0;
+volatile unsigned int telemetryDrops = 0;
+
+
+int cobsEncode(const unsigned char *in, int len, unsigned char *out){
+    int code = 0;       //index of the current code byte
+    int o = 1;
+    unsigned char run = 1;
+
+    for(int i = 0; i < len; i++){
+        if(in[i] == 0){
+            out[code] = run;
+            code = o++;
+            run = 1;
+        } else {
+            out[o++] = in[i];
+            run++;
+            //longest run one code byte can describe
+            if(run == 0xFF){
+                out[code] = run;
+                code = o++;
+                run = 1;
+            }
+        }
+    }
+    out[code] = run;
+    return o;
+}
+
+
+int cobsDecode(const unsigned char *in, int len, unsigned char *out){
+    int i = 0;
+    int o = 0;
+
+    while(i < len){
+        unsigned char run = in[i++];
+        if(run == 0 || i + run - 1 > len){
+            return -1;
+        }
+        for(int k = 1; k < run; k++){
+            if(in[i] == 0){
+                return -1;
+            }
+            out[o++] = in[i++];
+        }
+        //a short run stands for a zero, except at the very end
+        if(run != 0xFF && i < len){
+            out[o++] = 0;
+        }
+    }
+    return o;
+}
+
+
+//TX interrupt, moves bytes from the buffer into the UART
+//detaches itself once the buffer runs dry
+static void telemetryTxIrq(void){
+    unsigned char c;
+    while(telPort->writeable()){
+        if(!telBuffer.pop(c)){
+            telPort->attach(NULL, SerialBase::TxIrq);
+            telActive = false;
+            return;
+        }
+        telPort->putc(c);
+    }
+}
+
+
+//starts the TX interrupt if it is not running yet
+static void kickTelemetry(void){
+    bool start = false;
+
+    core_util_critical_section_enter();
+    if(!telActive){
+        telActive = true;
+        start = true;
+    }
+    core_util_critical_section_exit();
+
+    if(start){
+        //push the first byte by hand, the interrupt only fires on the
+        //transition to empty
+        telemetryTxIrq();
+        if(telActive){
+            telPort->attach(&telemetryTxIrq, SerialBase::TxIrq);
+        }
+    }
+}
+
+
+void telemetryInit(RawSerial *port){
+    telPort = port;
+    telBuffer.reset();
+    telActive = false;
+    telSequence = 0;
+    telemetryRecords = 0;
+    telemetryDrops = 0;
+}
+
+
+bool telemetrySending(void){
+    return telemetryEnabled || telActive;
+}
+
+
+//little endian field writers, return the next free byte
+static unsigned char *put16(unsigned char *p, unsigned int v){
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+    return p + 2;
+}
+
+static unsigned char *put32(unsigned char *p, unsigned int v){
+    p = put16(p, v & 0xFFFF);
+    return put16(p, v >> 16);
+}
+
+
+//fills in the header, returns where the payload goes
+static unsigned char *startRecord(unsigned char *record, TelemetryType type, unsigned int stampUs){
+    record[0] = type;
+    unsigned char *p = put16(record + 1, telSequence++);
+    return put32(p, stampUs);
+}
+
+
+//adds the checksum, encodes the record and queues it, all or nothing
+static void sendRecord(unsigned char *record, unsigned char *end){
+    unsigned char sum = 0;
+    for(unsigned char *p = record; p < end; p++){
+        sum += *p;
+    }
+    *end++ = -sum;
+
+    unsigned char frame[TEL_FRAME_MAX];
+    int len = cobsEncode(record, end - record, frame);
+    frame[len++] = 0;
+
+    if((int)telBuffer.space() < len){
+        telemetryDrops++;
+        return;
+    }
+    for(int i = 0; i < len; i++){
+        telBuffer.push(frame[i]);
+    }
+    telemetryRecords++;
+
+    kickTelemetry();
+}
+
+
+void telemetryRaw(const IRFrame &frame, unsigned int stampUs){
+    if(!telemetryEnabled || !telPort){
+        return;
+    }
+    unsigned char record[TEL_RECORD_MAX];
+    unsigned char *p = startRecord(record, TEL_RAW, stampUs);
+    for(int i = 0; i < IR_MAX_POINTS; i++){
+        p = put16(p, frame.point[i].x);
+        p = put16(p, frame.point[i].y);
+        *p++ = frame.point[i].size;
+    }
+    sendRecord(record, p);
+}
+
+
+void telemetryTrack(const TrackedFrame &frame, unsigned int stampUs){
+    if(!telemetryEnabled || !telPort){
+        return;
+    }
+    unsigned char record[TEL_RECORD_MAX];
+    unsigned char *p = startRecord(record, TEL_TRACK, stampUs);
+    *p++ = frame.valid;
+    for(int i = 0; i < IR_MAX_POINTS; i++){
+        p = put32(p, frame.x[i]);
+        p = put32(p, frame.y[i]);
+    }
+    sendRecord(record, p);
+}
+
+
+void telemetryGesture(int state, int prevState, unsigned int stampUs){
+    if(!telemetryEnabled || !telPort){
+        return;
+    }
+    unsigned char record[TEL_RECORD_MAX];
+    unsigned char *p = startRecord(record, TEL_GESTURE, stampUs);
+    *p++ = state;
+    *p++ = prevState;
+    sendRecord(record, p);
+}
+
+
+void telemetryReport(char buttons, char x, char y, char wheel, char pan, unsigned int stampUs){
+    if(!telemetryEnabled || !telPort){
+        return;
+    }
+    unsigned char record[TEL_RECORD_MAX];
+    unsigned char *p = startRecord(record, TEL_REPORT, stampUs);
+    *p++ = buttons;
+    *p++ = x;
+    *p++ = y;
+    *p++ = wheel;
+    *p++ = pan;
+    sendRecord(record, p);
+}
@@ -0,0 +1,86 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "mbed.h"
+#include "ir_frame.h"
+#include "kalman.h"
+
+//******************************************************************
+// Binary telemetry on the pc port
+//******************************************************************
+//
+// compact records instead of printf, so watching the pipeline at
+// 100 Hz fits in the 115200 baud link and does not stall it. records
+// are queued in a ring buffer and the UART TX interrupt sends them,
+// the main loop never waits on the port. when the buffer is full the
+// whole record is dropped, its sequence number is still used up so
+// the decoder sees the gap.
+//
+// each record is
+//   type       1 byte
+//   sequence   2 bytes, counts every record, sent or dropped
+//   stamp      4 bytes, us_ticker_read() time of the data
+//   payload    depends on type, see below
+//   checksum   1 byte, makes the sum of all record bytes 0 (mod 256)
+// all multi byte fields little endian. the record is COBS encoded
+// (no 0x00 left inside) and followed by a 0x00 delimiter, so a
+// decoder can start anywhere in the stream and resync on the next 0.
+//
+// text printed on pc while records are going out would end up inside
+// them, the decoder throws away the frame it lands in. so nothing else
+// prints on pc while telemetrySending(): the pc shell only takes the
+// line that turns telemetry off and answers nothing.
+//
+// host/telemetry_decode.cpp turns a captured stream back into CSV.
+
+enum TelemetryType {
+    TEL_RAW = 1,        //camera blobs before matching, 4x (x u16, y u16, size u8)
+    TEL_TRACK = 2,      //smoothed positions, valid u8, 4x (x s32, y s32) in Q8
+    TEL_GESTURE = 3,    //gesture state changed, new state u8, old state u8
+    TEL_REPORT = 4      //report sent, buttons u8, x s8, y s8, wheel s8, pan s8
+};
+
+#define TEL_HEADER_SIZE 7
+#define TEL_RAW_SIZE (IR_MAX_POINTS * 5)
+#define TEL_TRACK_SIZE (1 + IR_MAX_POINTS * 8)
+#define TEL_GESTURE_SIZE 2
+#define TEL_REPORT_SIZE 5
+
+//largest record, header + payload + checksum
+#define TEL_RECORD_MAX (TEL_HEADER_SIZE + TEL_TRACK_SIZE + 1)
+
+//COBS adds one byte per started 254, plus the delimiter
+#define TEL_FRAME_MAX (TEL_RECORD_MAX + TEL_RECORD_MAX / 254 + 2)
+
+//bytes of queued output, has to be a power of two
+#define TEL_BUFFER_SIZE 512
+
+//records are only queued while this is set (telemetry on pc)
+extern volatile bool telemetryEnabled;
+
+//true while telemetry is on or what it queued is still going out,
+//pc is not free for text until this is false
+bool telemetrySending(void);
+
+//hooks the TX interrupt of the given port
+void telemetryInit(RawSerial *port);
+
+//one record of each type, no-ops while telemetry is off
+void telemetryRaw(const IRFrame &frame, unsigned int stampUs);
+void telemetryTrack(const TrackedFrame &frame, unsigned int stampUs);
+void telemetryGesture(int state, int prevState, unsigned int stampUs);
+void telemetryReport(char buttons, char x, char y, char wheel, char pan, unsigned int stampUs);
+
+//COBS, encodes len bytes into out (at most len + len/254 + 1 bytes,
+//no delimiter) and returns the encoded length
+int cobsEncode(const unsigned char *in, int len, unsigned char *out);
+
+//decodes one frame (without the delimiter) into out, which needs
+//len bytes. returns the decoded length, -1 if the frame is malformed
+int cobsDecode(const unsigned char *in, int len, unsigned char *out);
+
+//records sent and dropped for lack of buffer space
+extern volatile unsigned int telemetryRecords;
+extern volatile unsigned int telemetryDrops;
+
+#endif